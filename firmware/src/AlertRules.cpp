@@ -0,0 +1,212 @@
+#include "AlertRules.h"
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+
+// Built-in rule table, in priority order
+static constexpr AlertRule BUILTIN_RULES[] = {
+    // name            field           condition    window sustain threshold clear
+    { "BOT DOWN",      FIELD_STATUS,   ALERT_BELOW, 1,     1,      1,        1   },
+    { "HIGH LATENCY",  FIELD_LATENCY,  ALERT_ABOVE, 1,     3,      500,      300 },
+    { "ERROR SPIKE",   FIELD_ERRORS,   ALERT_RISE,  3,     1,      5,        0   },
+    { "PNL DRAWDOWN",  FIELD_PNL,      ALERT_FALL,  10,    1,      2000,     500 },
+};
+
+static constexpr uint8_t BUILTIN_RULE_COUNT = sizeof(BUILTIN_RULES) / sizeof(BUILTIN_RULES[0]);
+
+static_assert(BUILTIN_RULE_COUNT <= MAX_ALERT_RULES, "Built-in rules exceed MAX_ALERT_RULES");
+
+static bool isLowCondition(AlertCondition condition) {
+    return condition == ALERT_BELOW;
+}
+
+AlertEngine::AlertEngine() : lastHeldSampleAt(0), heldSampled(false), nameUsed(0) {
+    loadBuiltin();
+}
+
+void AlertEngine::loadBuiltin() {
+    rules = BUILTIN_RULES;
+    numRules = BUILTIN_RULE_COUNT;
+    reset();
+}
+
+void AlertEngine::reset() {
+    memset(states, 0, sizeof(states));
+    memset(history, 0, sizeof(history));
+    historyHead = 0;
+    historySize = 0;
+    active = nullptr;
+    activeValue = 0;
+}
+
+int32_t AlertEngine::pastValue(MetricField field, uint8_t samplesAgo) const {
+    // historyHead points at the slot the next sample will be written to
+    uint8_t index = (historyHead + ALERT_HISTORY_LEN - 1 - samplesAgo) % ALERT_HISTORY_LEN;
+    return history[field][index];
+}
+
+const AlertRule* AlertEngine::evaluate(const MetricsData &data, int rssi) {
+    // Record this sample for every field
+    for (uint8_t f = FIELD_NONE + 1; f < FIELD_COUNT; f++) {
+        history[f][historyHead] = metricFieldValue(static_cast<MetricField>(f), data, rssi);
+    }
+    historyHead = (historyHead + 1) % ALERT_HISTORY_LEN;
+    if (historySize < ALERT_HISTORY_LEN) {
+        historySize++;
+    }
+
+    active = nullptr;
+
+    for (uint8_t i = 0; i < numRules; i++) {
+        const AlertRule &rule = rules[i];
+        RuleState &state = states[i];
+
+        int32_t measured = pastValue(rule.field, 0);
+
+        if (rule.condition == ALERT_RISE || rule.condition == ALERT_FALL) {
+            // Not enough history yet to look back that far
+            if (historySize <= rule.window) {
+                continue;
+            }
+            int32_t delta = measured - pastValue(rule.field, rule.window);
+            measured = (rule.condition == ALERT_RISE) ? delta : -delta;
+        }
+
+        bool low = isLowCondition(rule.condition);
+        bool triggered = low ? (measured < rule.threshold) : (measured > rule.threshold);
+        bool cleared = low ? (measured >= rule.clearLevel) : (measured <= rule.clearLevel);
+
+        if (state.firing) {
+            if (cleared) {
+                state.firing = false;
+                state.count = 0;
+            }
+        } else if (triggered) {
+            if (state.count < 255) {
+                state.count++;
+            }
+            if (state.count >= rule.sustain) {
+                state.firing = true;
+            }
+        } else {
+            state.count = 0;
+        }
+
+        if (state.firing && active == nullptr) {
+            active = &rule;
+            activeValue = measured;
+        }
+    }
+
+    return active;
+}
+
+bool AlertEngine::sampleHeld(const MetricsData &data, int rssi, unsigned long now, unsigned long intervalMs) {
+    // Unsigned difference handles millis() rollover
+    if (heldSampled && now - lastHeldSampleAt < intervalMs) {
+        return false;
+    }
+    lastHeldSampleAt = now;
+    heldSampled = true;
+    evaluate(data, rssi);
+    return true;
+}
+
+const char* AlertEngine::storeName(const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len > ALERT_NAME_MAX_LEN || nameUsed + len + 1 > sizeof(namePool)) {
+        return nullptr;
+    }
+    char* stored = namePool + nameUsed;
+    memcpy(stored, name, len + 1);
+    nameUsed += len + 1;
+    return stored;
+}
+
+bool AlertEngine::loadFromFile(const char* path) {
+    if (!LittleFS.exists(path)) {
+        return false;
+    }
+
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        Serial.println(F("Failed to open alerts file"));
+        return false;
+    }
+
+    // Rule files can hold MAX_ALERT_RULES entries; too big for a stack document
+    DynamicJsonDocument doc(ALERT_JSON_SIZE);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+
+    if (error) {
+        Serial.print(F("Alerts parse error: "));
+        Serial.println(error.c_str());
+        return false;
+    }
+
+    JsonArrayConst ruleList = doc["rules"];
+    if (ruleList.isNull() || ruleList.size() > MAX_ALERT_RULES) {
+        Serial.println(F("Alerts: invalid rule list"));
+        return false;
+    }
+
+    static const char* const CONDITION_KEYS[] = { "above", "below", "rise", "fall" };
+    nameUsed = 0;
+
+    for (size_t i = 0; i < ruleList.size(); i++) {
+        JsonObjectConst ruleObj = ruleList[i];
+        AlertRule &rule = fileRules[i];
+
+        const char* name = storeName(ruleObj["name"] | "");
+        if (name == nullptr) {
+            Serial.println(F("Alerts: missing or too long rule name"));
+            return false;
+        }
+        rule.name = name;
+
+        if (!metricFieldFromName(ruleObj["field"] | "", rule.field)) {
+            Serial.print(F("Alerts: unknown field in "));
+            Serial.println(name);
+            return false;
+        }
+
+        // Exactly one condition key selects the rule type and threshold
+        uint8_t conditions = 0;
+        for (uint8_t c = 0; c < 4; c++) {
+            if (ruleObj.containsKey(CONDITION_KEYS[c])) {
+                rule.condition = static_cast<AlertCondition>(c);
+                rule.threshold = ruleObj[CONDITION_KEYS[c]].as<int32_t>();
+                conditions++;
+            }
+        }
+        if (conditions != 1) {
+            Serial.print(F("Alerts: need exactly one of above/below/rise/fall in "));
+            Serial.println(name);
+            return false;
+        }
+
+        rule.clearLevel = ruleObj["clear"] | rule.threshold;
+        int window = ruleObj["window"] | 1;
+        int sustain = ruleObj["for"] | 1;
+
+        // Hysteresis must sit on the healthy side of the threshold
+        bool low = isLowCondition(rule.condition);
+        bool clearValid = low ? (rule.clearLevel >= rule.threshold) : (rule.clearLevel <= rule.threshold);
+
+        if (!clearValid || window < 1 || window >= ALERT_HISTORY_LEN || sustain < 1 || sustain > 255) {
+            Serial.print(F("Alerts: invalid clear/window/for in "));
+            Serial.println(name);
+            return false;
+        }
+        rule.window = window;
+        rule.sustain = sustain;
+    }
+
+    rules = fileRules;
+    numRules = ruleList.size();
+    reset();
+
+    Serial.print(F("Alert rules loaded: "));
+    Serial.println(numRules);
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef ALERT_RULES_H
+#define ALERT_RULES_H
+
+#include <Arduino.h>
+#include "Metrics.h"
+
+// Capacity of a rule table loaded from LittleFS
+#define MAX_ALERT_RULES 12
+#define ALERT_NAME_POOL_SIZE 192
+#define ALERT_NAME_MAX_LEN 15
+#define ALERT_JSON_SIZE 2048
+
+// Samples kept per field for rate-of-change rules
+#define ALERT_HISTORY_LEN 16
+
+enum AlertCondition : uint8_t {
+    ALERT_ABOVE,  // value > threshold
+    ALERT_BELOW,  // value < threshold
+    ALERT_RISE,   // value - value[window samples ago] > threshold
+    ALERT_FALL    // value[window samples ago] - value > threshold
+};
+
+// A rule fires once its condition has held for `sustain` consecutive samples
+// and clears when the measured value crosses back over `clearLevel`
+// (hysteresis; equal to threshold for none).
+struct AlertRule {
+    const char* name;       // Shown on the alert screen
+    MetricField field;
+    AlertCondition condition;
+    uint8_t window;         // RISE/FALL: samples back to compare against (1..ALERT_HISTORY_LEN-1)
+    uint8_t sustain;        // Consecutive samples required to fire (>= 1)
+    int32_t threshold;
+    int32_t clearLevel;
+};
+
+// Evaluates a compact rule table once per fetch in O(rules). Rule order is
+// priority order: the first firing rule is the one reported.
+class AlertEngine {
+public:
+    AlertEngine();
+
+    void loadBuiltin();
+    bool loadFromFile(const char* path);
+
+    // Feed one successful sample; returns the highest-priority firing rule
+    const AlertRule* evaluate(const MetricsData &data, int rssi);
+    // Multicast only delivers changed snapshots, so while it is live this is
+    // called every loop instead: it feeds the held snapshot once per
+    // `intervalMs`, keeping window and sustain in polling intervals.
+    // Returns true when it took a sample.
+    bool sampleHeld(const MetricsData &data, int rssi, unsigned long now, unsigned long intervalMs);
+    const AlertRule* activeRule() const { return active; }
+    // What the active rule compared against its threshold: the field value
+    // for ABOVE/BELOW, the change over the window for RISE/FALL (a drop is
+    // positive for FALL)
+    int32_t activeMeasured() const { return activeValue; }
+    void reset();
+
+    uint8_t ruleCount() const { return numRules; }
+
+private:
+    struct RuleState {
+        uint8_t count;
+        bool firing;
+    };
+
+    const AlertRule* rules;
+    uint8_t numRules;
+    const AlertRule* active;
+    int32_t activeValue;
+
+    RuleState states[MAX_ALERT_RULES];
+    int32_t history[FIELD_COUNT][ALERT_HISTORY_LEN];
+    uint8_t historyHead;
+    uint8_t historySize;
+    unsigned long lastHeldSampleAt;
+    bool heldSampled;
+
+    AlertRule fileRules[MAX_ALERT_RULES];
+    char namePool[ALERT_NAME_POOL_SIZE];
+    size_t nameUsed;
+
+    int32_t pastValue(MetricField field, uint8_t samplesAgo) const;
+    const char* storeName(const char* name);
+};
+
+#endif // ALERT_RULES_H
@@ -1,39 +1,71 @@
 #include "Config.h"
+#include "Crc32.h"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 
-bool loadConfig(AppConfig &config) {
-    // Set defaults first
-    strncpy(config.wifi.ssid, "", sizeof(config.wifi.ssid));
-    strncpy(config.wifi.password, "", sizeof(config.wifi.password));
-    strncpy(config.server.url, DEFAULT_SERVER_URL, sizeof(config.server.url));
-    config.refresh_ms = 3000;
+// On-flash layout of one config slot. Slots are written whole and verified
+// by CRC, so a torn write is simply ignored on the next boot.
+struct ConfigRecord {
+    uint32_t magic;     // CONFIG_RECORD_MAGIC
+    uint16_t version;   // CONFIG_RECORD_VERSION
+    uint16_t length;    // sizeof(AppConfig) at write time
+    uint32_t sequence;  // Incremented on every save, newest valid slot wins
+    AppConfig config;
+    uint32_t crc;       // CRC32 over all preceding bytes
+};
 
-    // LittleFS should already be mounted by main.cpp
-    if (!LittleFS.exists(CONFIG_FILE_PATH)) {
-        Serial.println(F("Config file not found, using defaults"));
-        return false;
-    }
+static const char* const slotPaths[2] = { CONFIG_SLOT_A_PATH, CONFIG_SLOT_B_PATH };
 
-    File file = LittleFS.open(CONFIG_FILE_PATH, "r");
+// Slot holding the record loaded at boot (-1 = none) and its sequence number
+static int activeSlot = -1;
+static uint32_t activeSequence = 0;
+
+static uint32_t recordCrc(const ConfigRecord &record) {
+    return crc32(reinterpret_cast<const uint8_t*>(&record), offsetof(ConfigRecord, crc));
+}
+
+static void setDefaults(AppConfig &config) {
+    // Zero the whole struct so padding and unused string tails hash identically
+    memset(&config, 0, sizeof(config));
+    strncpy(config.server.url, DEFAULT_SERVER_URL, sizeof(config.server.url) - 1);
+    config.refresh_ms = 3000;
+}
+
+static bool readSlot(int slot, ConfigRecord &record) {
+    File file = LittleFS.open(slotPaths[slot], "r");
     if (!file) {
-        Serial.println(F("Failed to open config file"));
         return false;
     }
 
-    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
-    DeserializationError error = deserializeJson(doc, file);
+    // Whole record in a single read
+    size_t len = file.read(reinterpret_cast<uint8_t*>(&record), sizeof(record));
     file.close();
 
-    if (error) {
-        Serial.print(F("Config parse error: "));
-        Serial.println(error.c_str());
+    if (len != sizeof(record)) {
         return false;
     }
+    if (record.magic != CONFIG_RECORD_MAGIC ||
+        record.version != CONFIG_RECORD_VERSION ||
+        record.length != sizeof(AppConfig)) {
+        return false;
+    }
+    if (record.crc != recordCrc(record)) {
+        Serial.print(F("Config slot CRC mismatch: "));
+        Serial.println(slotPaths[slot]);
+        return false;
+    }
+
+    // Never trust stored strings to be terminated
+    record.config.wifi.ssid[sizeof(record.config.wifi.ssid) - 1] = '\0';
+    record.config.wifi.password[sizeof(record.config.wifi.password) - 1] = '\0';
+    record.config.server.url[sizeof(record.config.server.url) - 1] = '\0';
+    return true;
+}
 
+static bool configFromJson(const JsonDocument &doc, AppConfig &config) {
     // Parse WiFi config
     if (doc.containsKey("wifi")) {
-        JsonObject wifi = doc["wifi"];
+        JsonObjectConst wifi = doc["wifi"];
         const char* ssid = wifi["ssid"] | "";
         const char* pass = wifi["pass"] | "";
         strncpy(config.wifi.ssid, ssid, sizeof(config.wifi.ssid) - 1);
@@ -42,7 +74,7 @@ bool loadConfig(AppConfig &config) {
 
     // Parse server config
     if (doc.containsKey("server")) {
-        JsonObject server = doc["server"];
+        JsonObjectConst server = doc["server"];
         const char* url = server["url"] | DEFAULT_SERVER_URL;
         strncpy(config.server.url, url, sizeof(config.server.url) - 1);
     }
@@ -53,40 +85,169 @@ bool loadConfig(AppConfig &config) {
     return validateConfig(config);
 }
 
+static bool importConfigFile(AppConfig &config) {
+    if (!LittleFS.exists(CONFIG_FILE_PATH)) {
+        Serial.println(F("Config file not found, using defaults"));
+        return false;
+    }
+
+    File file = LittleFS.open(CONFIG_FILE_PATH, "r");
+    if (!file) {
+        Serial.println(F("Failed to open config file"));
+        return false;
+    }
+
+    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+
+    if (error) {
+        Serial.print(F("Config parse error: "));
+        Serial.println(error.c_str());
+        return false;
+    }
+
+    return configFromJson(doc, config);
+}
+
+// Reads both slots into records; returns the newest valid one, or -1
+static int readNewestSlot(ConfigRecord records[2]) {
+    bool valid[2] = { readSlot(0, records[0]), readSlot(1, records[1]) };
+
+    if (valid[0] && valid[1]) {
+        // Signed difference keeps the comparison correct across sequence wrap
+        return ((int32_t)(records[1].sequence - records[0].sequence) > 0) ? 1 : 0;
+    }
+    if (valid[0] || valid[1]) {
+        return valid[0] ? 0 : 1;
+    }
+    return -1;
+}
+
+bool loadConfig(AppConfig &config) {
+    // Set defaults first
+    setDefaults(config);
+
+    // LittleFS should already be mounted by main.cpp
+    ConfigRecord records[2];
+    int slot = readNewestSlot(records);
+
+    if (slot >= 0) {
+        activeSlot = slot;
+        activeSequence = records[slot].sequence;
+        memcpy(&config, &records[slot].config, sizeof(config));
+        return validateConfig(config);
+    }
+
+    // No binary record yet: first boot after uploadfs or a legacy unit
+    if (!importConfigFile(config)) {
+        return false;
+    }
+
+    // Migrate so subsequent boots skip JSON parsing
+    if (saveConfig(config)) {
+        Serial.println(F("Imported config.json into binary store"));
+    } else {
+        Serial.println(F("Failed to migrate config.json into binary store"));
+    }
+    return true;
+}
+
+bool readStoredConfig(AppConfig &config) {
+    setDefaults(config);
+
+    ConfigRecord records[2];
+    int slot = readNewestSlot(records);
+    if (slot < 0) {
+        return false;
+    }
+
+    memcpy(&config, &records[slot].config, sizeof(config));
+    return true;
+}
+
 bool saveConfig(const AppConfig &config) {
     if (!validateConfig(config)) {
         Serial.println(F("Invalid config, cannot save"));
         return false;
     }
 
-    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
+    ConfigRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = CONFIG_RECORD_MAGIC;
+    record.version = CONFIG_RECORD_VERSION;
+    record.length = sizeof(AppConfig);
+    record.sequence = activeSequence + 1;
 
-    JsonObject wifi = doc.createNestedObject("wifi");
-    wifi["ssid"] = config.wifi.ssid;
-    wifi["pass"] = config.wifi.password;
+    // Copy strings field by field so bytes past the terminator stay zeroed
+    strncpy(record.config.wifi.ssid, config.wifi.ssid, sizeof(record.config.wifi.ssid) - 1);
+    strncpy(record.config.wifi.password, config.wifi.password, sizeof(record.config.wifi.password) - 1);
+    strncpy(record.config.server.url, config.server.url, sizeof(record.config.server.url) - 1);
+    record.config.refresh_ms = config.refresh_ms;
 
-    JsonObject server = doc.createNestedObject("server");
-    server["url"] = config.server.url;
+    record.crc = recordCrc(record);
 
-    doc["refresh_ms"] = config.refresh_ms;
+    // Always overwrite the slot that is NOT currently active
+    int slot = (activeSlot == 0) ? 1 : 0;
 
-    File file = LittleFS.open(CONFIG_FILE_PATH, "w");
+    File file = LittleFS.open(slotPaths[slot], "w");
     if (!file) {
-        Serial.println(F("Failed to open config file for writing"));
+        Serial.println(F("Failed to open config slot for writing"));
         return false;
     }
 
-    if (serializeJson(doc, file) == 0) {
+    size_t written = file.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+    file.close();
+
+    // Read back to make sure the slot is actually usable before switching to it
+    ConfigRecord verify;
+    if (written != sizeof(record) || !readSlot(slot, verify) || verify.sequence != record.sequence) {
         Serial.println(F("Failed to write config"));
-        file.close();
         return false;
     }
 
-    file.close();
+    activeSlot = slot;
+    activeSequence = record.sequence;
     Serial.println(F("Config saved successfully"));
     return true;
 }
 
+bool importConfigJson(const char* json, size_t len, AppConfig &config, bool &hasPassword) {
+    setDefaults(config);
+    hasPassword = false;
+
+    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, json, len);
+
+    if (error) {
+        Serial.print(F("Config parse error: "));
+        Serial.println(error.c_str());
+        return false;
+    }
+
+    hasPassword = doc["wifi"].containsKey("pass");
+    return configFromJson(doc, config);
+}
+
+size_t exportConfigJson(const AppConfig &config, char* buffer, size_t bufSize) {
+    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
+
+    // The password is never exported: the setup portal is an open AP
+    JsonObject wifi = doc.createNestedObject("wifi");
+    wifi["ssid"] = config.wifi.ssid;
+
+    JsonObject server = doc.createNestedObject("server");
+    server["url"] = config.server.url;
+
+    doc["refresh_ms"] = config.refresh_ms;
+
+    if (measureJson(doc) >= bufSize) {
+        return 0;
+    }
+
+    return serializeJson(doc, buffer, bufSize);
+}
+
 bool validateConfig(const AppConfig &config) {
     // Validate SSID length
     size_t ssidLen = strlen(config.wifi.ssid);
@@ -25,7 +25,15 @@
 #define MAX_REFRESH_MS 15000
 
 // File paths
-#define CONFIG_FILE_PATH "/config.json"
+#define CONFIG_FILE_PATH "/config.json"      // JSON import/export format
+#define CONFIG_SLOT_A_PATH "/config.a.bin"   // Binary config record, slot A
+#define CONFIG_SLOT_B_PATH "/config.b.bin"   // Binary config record, slot B
+#define LAYOUT_FILE_PATH "/layout.json"      // Optional custom screen layout
+#define ALERTS_FILE_PATH "/alerts.json"      // Optional custom alert rules
+
+// Binary config record
+#define CONFIG_RECORD_MAGIC 0x43425241UL     // "ARBC" little-endian
+#define CONFIG_RECORD_VERSION 1
 
 // JSON buffer sizes
 #define CONFIG_JSON_SIZE 256
@@ -35,8 +43,59 @@
 #define HTTP_TIMEOUT_MS 2000
 #define MAX_CONSECUTIVE_FAILURES 3
 
+// Power settings
+// 0 = radio always on, 1 = modem sleep, 2 = light sleep between deadlines
+#ifndef DEFAULT_POWER_MODE
+#define DEFAULT_POWER_MODE 1
+#endif
+#define POWER_RESPONSIVE_IDLE_MS 250  // Idle slice while multicast is live or the mirror has clients
+#define POWER_MAX_IDLE_MS 1000        // Longest single idle; the loop re-checks mirror, WiFi and OTA after it
+#define POWER_LISTEN_INTERVAL 3       // Light sleep wakes for every 3rd DTIM beacon to fetch buffered frames
+
+// Typical ESP8266 module current per state, for the average-current estimate
+#define POWER_MA_AWAKE 70
+#define POWER_MA_IDLE 56
+#define POWER_MA_MODEM_SLEEP 15
+#define POWER_MA_LIGHT_SLEEP 1
+
+// LAN mirror settings (station mode only)
+#ifndef MIRROR_HTTP_PORT
+#define MIRROR_HTTP_PORT 80
+#endif
+#define MIRROR_CLIENT_WINDOW_MS 10000   // A request keeps the loop responsive this long
+
+// Multicast push settings (falls back to HTTP polling when no datagrams arrive)
+#ifndef MULTICAST_ENABLED
+#define MULTICAST_ENABLED 1
+#endif
+#ifndef MULTICAST_GROUP
+#define MULTICAST_GROUP 239,77,66,1
+#endif
+#ifndef MULTICAST_PORT
+#define MULTICAST_PORT 5007
+#endif
+#define MULTICAST_TIMEOUT_MS 10000      // Silence after which HTTP polling resumes
+#define MULTICAST_RESTART_WINDOW 16     // Jump back this far = restart, for senders without an epoch
+
+// OTA update settings (images must be signed with the key in OtaKey.h)
+#ifndef OTA_ENABLED
+#define OTA_ENABLED 1
+#endif
+#ifndef FIRMWARE_BUILD
+#define FIRMWARE_BUILD 0                // Compared against the manifest's build; 0 = unnumbered, OTA off
+#endif
+#define OTA_MANIFEST_PATH "/ota/manifest.json"
+#define OTA_REPORT_PATH "/ota/report"
+#define OTA_MANIFEST_JSON_SIZE 512
+#define OTA_FIRST_CHECK_MS 30000UL      // After boot, once metrics are flowing
+#define OTA_CHECK_INTERVAL_MS 900000UL  // 15 minutes
+#define OTA_RETRY_MIN_MS 60000UL        // First retry after a failed transfer, doubling up to the interval
+#define OTA_CHUNK_SIZE 1024             // Bytes moved from the socket to flash per write
+#define OTA_SLICE_MS 20                 // Download time per loop, so rendering continues
+#define OTA_STALL_TIMEOUT_MS 10000      // No data for this long aborts the update
+
 // UI settings
-#define SCREEN_ROTATION_MS 5000
+#define SCREEN_ROTATION_MS 5000         // Default per-screen duration
 #define WIFI_STATUS_DISPLAY_MS 3000
 
 // SoftAP settings
@@ -58,8 +117,19 @@ struct AppConfig {
 };
 
 // Config management functions
+// loadConfig() reads the newest valid binary slot; if none exists it imports
+// CONFIG_FILE_PATH once and migrates it into the binary store.
+// saveConfig() always writes the inactive slot, so a power cut mid-write
+// leaves the previous record intact.
 bool loadConfig(AppConfig &config);
+// Newest valid binary slot only: no JSON import, no migration, no writes
+bool readStoredConfig(AppConfig &config);
 bool saveConfig(const AppConfig &config);
 bool validateConfig(const AppConfig &config);
 
+// JSON import/export (portal and data/config.json). The export leaves out
+// wifi.pass; hasPassword tells whether an imported file carries the key.
+bool importConfigJson(const char* json, size_t len, AppConfig &config, bool &hasPassword);
+size_t exportConfigJson(const AppConfig &config, char* buffer, size_t bufSize);
+
 #endif // CONFIG_H
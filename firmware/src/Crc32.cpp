@@ -0,0 +1,14 @@
+#include "Crc32.h"
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+    // Bitwise rather than table-driven: inputs are tens of bytes, and this
+    // saves 1 KB of RAM on the ESP8266
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
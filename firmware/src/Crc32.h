@@ -0,0 +1,9 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <Arduino.h>
+
+// CRC-32 (IEEE 802.3, reflected, as zlib / Go's crc32.ChecksumIEEE)
+uint32_t crc32(const uint8_t* data, size_t len);
+
+#endif // CRC32_H
@@ -1,7 +1,7 @@
 #include "Display.h"
 #include <Arduino.h>
 
-Display::Display() : tft() {}
+Display::Display() : tft(), layoutScreen(-1) {}
 
 void Display::begin() {
     tft.init();
@@ -11,6 +11,7 @@ void Display::begin() {
 
 void Display::clear() {
     tft.fillScreen(TFT_BLACK);
+    layoutScreen = -1;
 }
 
 void Display::drawCentered(const char* text, int y, uint16_t color, uint8_t font) {
@@ -62,64 +63,95 @@ void Display::showWiFiSetupMode(const char* apName) {
     drawCentered("to configure", 190, TFT_GREEN, 2);
 }
 
-void Display::showStatus(const MetricsData &data, int rssi) {
-    clear();
-    
-    // Title
-    drawCentered("STATUS", 30, TFT_YELLOW, 4);
-    
-    // Bot status
-    const char* statusText = (data.status == 1) ? "OK" : "DOWN";
-    uint16_t statusColor = (data.status == 1) ? TFT_GREEN : TFT_RED;
-    drawCentered("Bot:", 80, TFT_WHITE, 2);
-    drawCentered(statusText, 105, statusColor, 4);
+void Display::drawLayout(const Layout &layout, uint8_t screenIndex, const MetricsData &data, int rssi) {
+    const ScreenDef &screen = layout.screen(screenIndex);
+    bool fullRedraw = (layoutScreen != screenIndex);
     
-    // WiFi RSSI
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "WiFi: %d dBm", rssi);
-    drawCentered(buffer, 150, TFT_CYAN, 2);
+    if (fullRedraw) {
+        clear();
+        layoutScreen = screenIndex;
+    }
     
-    // Latency
-    snprintf(buffer, sizeof(buffer), "Latency: %d ms", data.latency);
-    drawCentered(buffer, 180, TFT_WHITE, 2);
+    for (uint8_t i = 0; i < screen.opCount; i++) {
+        uint8_t index = screen.firstOp + i;
+        const DrawOp &op = layout.op(index);
+        
+        // Static text only needs drawing after a clear
+        if (op.field == FIELD_NONE) {
+            if (fullRedraw) {
+                drawCentered(op.text, op.y, op.color, op.font);
+            }
+            continue;
+        }
+        
+        int32_t value = metricFieldValue(op.field, data, rssi);
+        if (!fullRedraw && value == opValues[index]) {
+            continue;
+        }
+        
+        opValues[index] = value;
+        drawOp(op, value);
+    }
 }
 
-void Display::showArb(const MetricsData &data) {
-    clear();
+void Display::drawOp(const DrawOp &op, int32_t value) {
+    char valueText[24];
+    switch (op.format) {
+        case FORMAT_PERCENT:
+            formatPercent(value, valueText, sizeof(valueText));
+            break;
+        case FORMAT_PNL:
+            formatPNL(value, valueText, sizeof(valueText));
+            break;
+        case FORMAT_STATUS:
+            snprintf(valueText, sizeof(valueText), "%s", (value == 1) ? "OK" : "DOWN");
+            break;
+        default:
+            snprintf(valueText, sizeof(valueText), "%ld", (long)value);
+            break;
+    }
     
-    // Title
-    drawCentered("ARBITRAGE", 30, TFT_YELLOW, 4);
+    // Expand the "{}" placeholder
+    char text[64];
+    const char* slot = strstr(op.text, "{}");
+    if (slot != nullptr) {
+        snprintf(text, sizeof(text), "%.*s%s%s", (int)(slot - op.text), op.text, valueText, slot + 2);
+    } else {
+        snprintf(text, sizeof(text), "%s", op.text);
+    }
     
-    // Active triangles
-    drawCentered("Active:", 80, TFT_WHITE, 2);
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%d", data.activeTriangles);
-    drawCentered(buffer, 110, TFT_GREEN, 4);
+    uint16_t color = op.color;
+    if (op.colorMode == COLOR_AT_LEAST && value < op.threshold) {
+        color = op.altColor;
+    } else if (op.colorMode == COLOR_AT_MOST && value > op.threshold) {
+        color = op.altColor;
+    }
     
-    // Best percentage
-    drawCentered("Best %:", 160, TFT_WHITE, 2);
-    formatPercent(data.bestArb, buffer, sizeof(buffer));
-    drawCentered(buffer, 190, TFT_CYAN, 4);
+    // Full-width padding with a background color overwrites the previous
+    // value in place, so no clear is needed
+    tft.setTextColor(color, TFT_BLACK);
+    tft.setTextDatum(MC_DATUM);
+    tft.setTextPadding(TFT_WIDTH);
+    tft.drawString(text, TFT_WIDTH / 2, op.y, op.font);
+    tft.setTextPadding(0);
 }
 
-void Display::showPNL(const MetricsData &data) {
-    clear();
-    
-    // Title
-    drawCentered("PNL TODAY", 30, TFT_YELLOW, 4);
-    
-    // PNL amount
-    char buffer[32];
-    formatPNL(data.pnl, buffer, sizeof(buffer));
+void Display::showAlert(const char* message, const char* detail) {
+    tft.fillScreen(TFT_RED);
+    layoutScreen = -1;
+    drawCentered(message, 120, TFT_WHITE, 4);
     
-    uint16_t pnlColor = (data.pnl >= 0) ? TFT_GREEN : TFT_RED;
-    drawCentered(buffer, 120, pnlColor, 4);
-    drawCentered("USDT", 160, TFT_WHITE, 2);
+    if (detail != nullptr) {
+        drawCentered(detail, 160, TFT_WHITE, 2);
+    }
 }
 
-void Display::showAlert(const char* message) {
-    tft.fillScreen(TFT_RED);
-    drawCentered(message, 120, TFT_WHITE, 4);
+void Display::drawProgress(uint8_t percent) {
+    // Thin bar along the bottom edge, drawn over whatever screen is showing
+    int16_t filled = (int32_t)TFT_WIDTH * min(percent, (uint8_t)100) / 100;
+    int16_t y = TFT_HEIGHT - PROGRESS_BAR_HEIGHT;
+    tft.fillRect(0, y, filled, PROGRESS_BAR_HEIGHT, TFT_CYAN);
+    tft.fillRect(filled, y, TFT_WIDTH - filled, PROGRESS_BAR_HEIGHT, TFT_DARKGREY);
 }
 
 void Display::formatPNL(int cents, char* buffer, size_t bufSize) {
@@ -2,6 +2,10 @@
 #define DISPLAY_H
 
 #include <TFT_eSPI.h>
+#include "Layout.h"
+#include "Metrics.h"
+
+#define PROGRESS_BAR_HEIGHT 4
 
 enum ScreenType {
     SCREEN_BOOT,
@@ -14,16 +18,6 @@ enum ScreenType {
     SCREEN_ALERT
 };
 
-struct MetricsData {
-    int status;          // s: 1=ok, 0=down
-    int latency;         // l: ms
-    int activeTriangles; // a: count
-    int bestArb;         // b: percentage × 100
-    int pnl;             // p: cents
-    int errors;          // e: count
-    uint32_t timestamp;  // ts: epoch seconds (uint32_t for consistency, valid until year 2106)
-};
-
 class Display {
 public:
     Display();
@@ -35,13 +29,16 @@ public:
     void showWiFiConnected(const char* ssid, const char* ip);
     void showWiFiSetupMode(const char* apName);
     
-    // Dashboard screens
-    void showStatus(const MetricsData &data, int rssi);
-    void showArb(const MetricsData &data);
-    void showPNL(const MetricsData &data);
+    // Dashboard screens: runs one screen of the layout draw list. Switching
+    // screens redraws everything; otherwise only ops whose bound field
+    // changed since the last call are redrawn.
+    void drawLayout(const Layout &layout, uint8_t screenIndex, const MetricsData &data, int rssi);
     
-    // Alert screen
-    void showAlert(const char* message);
+    // Alert screen, with an optional smaller detail line
+    void showAlert(const char* message, const char* detail = nullptr);
+    
+    // Firmware download progress, overlaid on the current screen
+    void drawProgress(uint8_t percent);
     
     // Utility
     void clear();
@@ -49,7 +46,12 @@ public:
 private:
     TFT_eSPI tft;
     
+    // Screen currently on the panel (-1 = something other than a layout screen)
+    int16_t layoutScreen;
+    int32_t opValues[MAX_LAYOUT_OPS];
+    
     void drawCentered(const char* text, int y, uint16_t color, uint8_t font);
+    void drawOp(const DrawOp &op, int32_t value);
     void formatPNL(int cents, char* buffer, size_t bufSize);
     void formatPercent(int value, char* buffer, size_t bufSize);
 };
@@ -0,0 +1,241 @@
+#include "Layout.h"
+#include "Config.h"
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+#include <TFT_eSPI.h>
+
+// Built-in layout, compiled into flat tables at build time
+
+static constexpr DrawOp labelOp(const char* text, uint8_t y, uint8_t font, uint16_t color) {
+    return DrawOp{ text, FIELD_NONE, FORMAT_INT, COLOR_FIXED, font, y, color, color, 0 };
+}
+
+static constexpr DrawOp fieldOp(MetricField field, LayoutFormat format, const char* text,
+                              uint8_t y, uint8_t font, uint16_t color,
+                              LayoutColorMode mode = COLOR_FIXED, int32_t threshold = 0,
+                              uint16_t altColor = TFT_RED) {
+    return DrawOp{ text, field, format, mode, font, y, color, altColor, threshold };
+}
+
+static constexpr DrawOp BUILTIN_OPS[] = {
+    // STATUS
+    labelOp("STATUS", 30, 4, TFT_YELLOW),
+    labelOp("Bot:", 80, 2, TFT_WHITE),
+    fieldOp(FIELD_STATUS, FORMAT_STATUS, "{}", 105, 4, TFT_GREEN, COLOR_AT_LEAST, 1),
+    fieldOp(FIELD_RSSI, FORMAT_INT, "WiFi: {} dBm", 150, 2, TFT_CYAN),
+    fieldOp(FIELD_LATENCY, FORMAT_INT, "Latency: {} ms", 180, 2, TFT_WHITE),
+
+    // ARBITRAGE
+    labelOp("ARBITRAGE", 30, 4, TFT_YELLOW),
+    labelOp("Active:", 80, 2, TFT_WHITE),
+    fieldOp(FIELD_ACTIVE, FORMAT_INT, "{}", 110, 4, TFT_GREEN),
+    labelOp("Best %:", 160, 2, TFT_WHITE),
+    fieldOp(FIELD_BEST_ARB, FORMAT_PERCENT, "{}", 190, 4, TFT_CYAN),
+
+    // PNL
+    labelOp("PNL TODAY", 30, 4, TFT_YELLOW),
+    fieldOp(FIELD_PNL, FORMAT_PNL, "{}", 120, 4, TFT_GREEN, COLOR_AT_LEAST, 0),
+    labelOp("USDT", 160, 2, TFT_WHITE),
+};
+
+static constexpr ScreenDef BUILTIN_SCREENS[] = {
+    { 0, 5, SCREEN_ROTATION_MS },
+    { 5, 5, SCREEN_ROTATION_MS },
+    { 10, 3, SCREEN_ROTATION_MS },
+};
+
+static constexpr uint8_t BUILTIN_OP_COUNT = sizeof(BUILTIN_OPS) / sizeof(BUILTIN_OPS[0]);
+static constexpr uint8_t BUILTIN_SCREEN_COUNT = sizeof(BUILTIN_SCREENS) / sizeof(BUILTIN_SCREENS[0]);
+
+static_assert(BUILTIN_OP_COUNT <= MAX_LAYOUT_OPS, "Built-in layout exceeds MAX_LAYOUT_OPS");
+static_assert(BUILTIN_SCREENS[BUILTIN_SCREEN_COUNT - 1].firstOp +
+              BUILTIN_SCREENS[BUILTIN_SCREEN_COUNT - 1].opCount == BUILTIN_OP_COUNT,
+              "Built-in screen table does not cover the draw list");
+
+// Name tables for JSON layouts
+
+struct NamedValue {
+    const char* name;
+    uint16_t value;
+};
+
+static const NamedValue FORMAT_NAMES[] = {
+    { "int", FORMAT_INT }, { "pct", FORMAT_PERCENT },
+    { "pnl", FORMAT_PNL }, { "status", FORMAT_STATUS },
+};
+
+static const NamedValue COLOR_NAMES[] = {
+    { "white", TFT_WHITE }, { "black", TFT_BLACK }, { "red", TFT_RED },
+    { "green", TFT_GREEN }, { "cyan", TFT_CYAN }, { "yellow", TFT_YELLOW },
+    { "orange", TFT_ORANGE }, { "blue", TFT_BLUE },
+};
+
+template <size_t N>
+static bool lookupName(const NamedValue (&table)[N], const char* name, uint16_t &out) {
+    for (size_t i = 0; i < N; i++) {
+        if (strcmp(table[i].name, name) == 0) {
+            out = table[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Accepts a color name or a raw RGB565 integer
+static bool parseColor(JsonVariantConst value, uint16_t fallback, uint16_t &out) {
+    if (value.isNull()) {
+        out = fallback;
+        return true;
+    }
+    if (value.is<const char*>()) {
+        return lookupName(COLOR_NAMES, value.as<const char*>(), out);
+    }
+    if (value.is<int>()) {
+        out = value.as<uint16_t>();
+        return true;
+    }
+    return false;
+}
+
+static bool validFont(int font) {
+    return font == 1 || font == 2 || font == 4 || font == 6 || font == 7 || font == 8;
+}
+
+Layout::Layout() : textUsed(0) {
+    loadBuiltin();
+}
+
+void Layout::loadBuiltin() {
+    ops = BUILTIN_OPS;
+    screens = BUILTIN_SCREENS;
+    numOps = BUILTIN_OP_COUNT;
+    numScreens = BUILTIN_SCREEN_COUNT;
+}
+
+const char* Layout::storeText(const char* text) {
+    size_t len = strlen(text) + 1;
+    if (textUsed + len > sizeof(textPool)) {
+        return nullptr;
+    }
+    char* stored = textPool + textUsed;
+    memcpy(stored, text, len);
+    textUsed += len;
+    return stored;
+}
+
+bool Layout::loadFromFile(const char* path) {
+    if (!LittleFS.exists(path)) {
+        return false;
+    }
+
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        Serial.println(F("Failed to open layout file"));
+        return false;
+    }
+
+    // 3 KB does not fit the 4 KB stack; this heap block is gone once setup() ends
+    DynamicJsonDocument doc(LAYOUT_JSON_SIZE);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+
+    if (error) {
+        Serial.print(F("Layout parse error: "));
+        Serial.println(error.c_str());
+        return false;
+    }
+
+    JsonArrayConst screenList = doc["screens"];
+    if (screenList.isNull() || screenList.size() == 0 || screenList.size() > MAX_LAYOUT_SCREENS) {
+        Serial.println(F("Layout: invalid screen list"));
+        return false;
+    }
+
+    uint8_t opIndex = 0;
+    textUsed = 0;
+
+    for (size_t s = 0; s < screenList.size(); s++) {
+        JsonObjectConst screenObj = screenList[s];
+        JsonArrayConst opList = screenObj["ops"];
+
+        if (opList.isNull() || opIndex + opList.size() > MAX_LAYOUT_OPS) {
+            Serial.println(F("Layout: too many ops"));
+            return false;
+        }
+
+        uint32_t durationMs = screenObj["ms"] | SCREEN_ROTATION_MS;
+        if (durationMs < MIN_SCREEN_MS) durationMs = MIN_SCREEN_MS;
+        if (durationMs > MAX_SCREEN_MS) durationMs = MAX_SCREEN_MS;
+
+        fileScreens[s].firstOp = opIndex;
+        fileScreens[s].opCount = opList.size();
+        fileScreens[s].durationMs = durationMs;
+
+        for (size_t i = 0; i < opList.size(); i++) {
+            JsonObjectConst opObj = opList[i];
+            DrawOp &op = fileOps[opIndex++];
+
+            MetricField field = FIELD_NONE;
+            uint16_t format = FORMAT_INT;
+            const char* fieldName = opObj["field"] | "";
+            const char* formatName = opObj["fmt"] | "int";
+
+            if (fieldName[0] != '\0' && !metricFieldFromName(fieldName, field)) {
+                Serial.print(F("Layout: unknown field "));
+                Serial.println(fieldName);
+                return false;
+            }
+            if (!lookupName(FORMAT_NAMES, formatName, format)) {
+                Serial.print(F("Layout: unknown format "));
+                Serial.println(formatName);
+                return false;
+            }
+
+            const char* text = storeText(opObj["text"] | (field == FIELD_NONE ? "" : "{}"));
+            if (text == nullptr) {
+                Serial.println(F("Layout: text pool exhausted"));
+                return false;
+            }
+
+            op.text = text;
+            op.field = field;
+            op.format = static_cast<LayoutFormat>(format);
+            int font = opObj["font"] | 2;
+            int y = opObj["y"] | 120;
+
+            if (!validFont(font) || y < 0 || y >= TFT_HEIGHT) {
+                Serial.println(F("Layout: invalid font or position"));
+                return false;
+            }
+            op.font = font;
+            op.y = y;
+            if (!parseColor(opObj["color"], TFT_WHITE, op.color) ||
+                !parseColor(opObj["alt"], TFT_RED, op.altColor)) {
+                Serial.println(F("Layout: unknown color"));
+                return false;
+            }
+
+            // Color threshold: "min" keeps color while value >= min, "max" while value <= max
+            if (opObj.containsKey("min")) {
+                op.colorMode = COLOR_AT_LEAST;
+                op.threshold = opObj["min"].as<int32_t>();
+            } else if (opObj.containsKey("max")) {
+                op.colorMode = COLOR_AT_MOST;
+                op.threshold = opObj["max"].as<int32_t>();
+            } else {
+                op.colorMode = COLOR_FIXED;
+                op.threshold = 0;
+            }
+        }
+    }
+
+    ops = fileOps;
+    screens = fileScreens;
+    numOps = opIndex;
+    numScreens = screenList.size();
+
+    Serial.print(F("Layout loaded: "));
+    Serial.print(numScreens);
+    Serial.println(F(" screens"));
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <Arduino.h>
+#include "Metrics.h"
+
+// Capacity of a layout loaded from LittleFS
+#define MAX_LAYOUT_OPS 32
+#define MAX_LAYOUT_SCREENS 8
+#define LAYOUT_TEXT_POOL_SIZE 384
+#define LAYOUT_JSON_SIZE 3072
+
+// Screen duration bounds for file layouts
+#define MIN_SCREEN_MS 1000
+#define MAX_SCREEN_MS 60000
+
+enum LayoutFormat : uint8_t {
+    FORMAT_INT,      // 42
+    FORMAT_PERCENT,  // 0.18%
+    FORMAT_PNL,      // -$4.82
+    FORMAT_STATUS    // OK / DOWN
+};
+
+enum LayoutColorMode : uint8_t {
+    COLOR_FIXED,     // Always color
+    COLOR_AT_LEAST,  // value >= threshold ? color : altColor
+    COLOR_AT_MOST    // value <= threshold ? color : altColor
+};
+
+// One centered text draw. For bound ops, "{}" in text is replaced by the
+// formatted field value.
+struct DrawOp {
+    const char* text;
+    MetricField field;      // FIELD_NONE = static text
+    LayoutFormat format;
+    LayoutColorMode colorMode;
+    uint8_t font;
+    uint8_t y;
+    uint16_t color;
+    uint16_t altColor;
+    int32_t threshold;
+};
+
+struct ScreenDef {
+    uint8_t firstOp;
+    uint8_t opCount;
+    uint16_t durationMs;
+};
+
+// Flat draw list plus screen table. Either points at the constexpr built-in
+// tables or at storage filled from a JSON layout file at boot.
+class Layout {
+public:
+    Layout();
+
+    void loadBuiltin();
+    bool loadFromFile(const char* path);
+
+    uint8_t screenCount() const { return numScreens; }
+    uint8_t opCount() const { return numOps; }
+    const ScreenDef &screen(uint8_t index) const { return screens[index]; }
+    const DrawOp &op(uint8_t index) const { return ops[index]; }
+
+private:
+    const DrawOp* ops;
+    const ScreenDef* screens;
+    uint8_t numOps;
+    uint8_t numScreens;
+
+    DrawOp fileOps[MAX_LAYOUT_OPS];
+    ScreenDef fileScreens[MAX_LAYOUT_SCREENS];
+    char textPool[LAYOUT_TEXT_POOL_SIZE];
+    size_t textUsed;
+
+    const char* storeText(const char* text);
+};
+
+#endif // LAYOUT_H
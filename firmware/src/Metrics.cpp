@@ -0,0 +1,260 @@
+#include "Metrics.h"
+#include "Config.h"
+
+static_assert(METRICS_JSON_MAX_SIZE < METRICS_JSON_SIZE, "METRICS_JSON_SIZE too small for the schema");
+static_assert(METRICS_SNAPSHOT_SIZE + 4 <= METRICS_DATAGRAM_MAX_SIZE, "Schema exceeds datagram limit");
+
+static const char* const FIELD_NAMES[FIELD_COUNT] = {
+    "",
+#define METRICS_FIELD_NAME(name, member, key, since) key,
+    METRICS_FIELDS(METRICS_FIELD_NAME)
+#undef METRICS_FIELD_NAME
+    "rssi"
+};
+
+static void writeLE32(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = (value >> 24) & 0xFF;
+}
+
+static uint32_t readLE32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+void encodeMetricsSnapshot(uint8_t* out, uint8_t epoch, uint32_t sequence, const MetricsData &data) {
+    // Header: 'A', 'M', version, epoch
+    out[0] = 'A';
+    out[1] = 'M';
+    out[2] = METRICS_SNAPSHOT_VERSION;
+    out[3] = epoch;
+    writeLE32(out + 4, sequence);
+    for (uint8_t i = 0; i < METRICS_FIELD_TOTAL; i++) {
+        writeLE32(out + METRICS_SNAPSHOT_HEADER_SIZE + 4 * i, (uint32_t)metricsGetField(data, i));
+    }
+}
+
+bool decodeMetricsSnapshot(const uint8_t* in, size_t len, uint8_t &epoch, uint32_t &sequence, MetricsData &data) {
+    if (len < METRICS_SNAPSHOT_HEADER_SIZE || in[0] != 'A' || in[1] != 'M' || in[2] == 0) {
+        return false;
+    }
+
+    // Older versions carry a prefix of our fields; newer ones append fields
+    // we skip. Either way the length must match what the version promises.
+    uint8_t version = in[2];
+    size_t fields = (len - METRICS_SNAPSHOT_HEADER_SIZE) / 4;
+    if ((len - METRICS_SNAPSHOT_HEADER_SIZE) % 4 != 0) {
+        return false;
+    }
+    if (version <= METRICS_SNAPSHOT_VERSION ? fields != metricsFieldCount(version)
+                                            : fields < METRICS_FIELD_TOTAL) {
+        return false;
+    }
+
+    epoch = in[3];
+    sequence = readLE32(in + 4);
+    data = MetricsData();
+    for (uint8_t i = 0; i < METRICS_FIELD_TOTAL && i < fields; i++) {
+        uint32_t raw = readLE32(in + METRICS_SNAPSHOT_HEADER_SIZE + 4 * i);
+        metricsSetField(data, i, METRICS_FIELD_UNSIGNED[i] ? (int64_t)raw : (int64_t)(int32_t)raw);
+    }
+    return true;
+}
+
+static const char* skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        p++;
+    }
+    return p;
+}
+
+// Returns the character after the closing quote, or nullptr if unterminated
+static const char* skipString(const char* p, const char* end) {
+    for (p++; p < end; p++) {
+        if (*p == '\\') {
+            p++;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+// Skips any JSON value, including nested objects and arrays from newer servers
+static const char* skipValue(const char* p, const char* end) {
+    int depth = 0;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            p = skipString(p, end);
+            if (p == nullptr) {
+                return nullptr;
+            }
+            continue;
+        }
+        if (depth == 0 && (c == ',' || c == '}' || c == ']')) {
+            return p;
+        }
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+        p++;
+    }
+    return nullptr;
+}
+
+// A plain JSON integer: optional '-', no leading zeros, no fraction or
+// exponent. Returns the character after it, or nullptr if it is anything else
+// or does not fit 32 bits (signed or unsigned as the field requires).
+static const char* parseInteger(const char* p, const char* end, bool isUnsigned, int64_t &value) {
+    bool negative = (p < end && *p == '-');
+    if (negative) {
+        p++;
+    }
+    if (p >= end || *p < '0' || *p > '9') {
+        return nullptr;
+    }
+    if (*p == '0' && p + 1 < end && p[1] >= '0' && p[1] <= '9') {
+        return nullptr;
+    }
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        // Stop before int64 could overflow; anything this large is out of range
+        if (value > (int64_t)UINT32_MAX) {
+            return nullptr;
+        }
+        p++;
+    }
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E')) {
+        return nullptr;
+    }
+    if (negative) {
+        value = -value;
+    }
+
+    int64_t low = isUnsigned ? 0 : INT32_MIN;
+    int64_t high = isUnsigned ? (int64_t)UINT32_MAX : INT32_MAX;
+    return (value >= low && value <= high) ? p : nullptr;
+}
+
+// Accepts the closing brace only if nothing but whitespace follows it
+static bool finishObject(const char* p, const char* end, const MetricsData &parsed, MetricsData &data) {
+    if (skipSpace(p + 1, end) != end) {
+        return false;
+    }
+    data = parsed;
+    return true;
+}
+
+bool parseMetricsJson(const char* json, size_t len, MetricsData &data) {
+    const char* end = json + len;
+    const char* p = skipSpace(json, end);
+    if (p >= end || *p != '{') {
+        return false;
+    }
+
+    MetricsData parsed = MetricsData();
+    p = skipSpace(p + 1, end);
+    if (p < end && *p == '}') {
+        return finishObject(p, end, parsed, data);
+    }
+
+    while (p < end) {
+        if (*p != '"') {
+            return false;
+        }
+        const char* key = p + 1;
+        p = skipString(p, end);
+        if (p == nullptr) {
+            return false;
+        }
+        int index = metricsKeyIndex(key, p - 1 - key);
+
+        p = skipSpace(p, end);
+        if (p >= end || *p != ':') {
+            return false;
+        }
+        p = skipSpace(p + 1, end);
+
+        if (index >= 0) {
+            // Known keys take an in-range integer, or null (left at 0)
+            if (end - p >= 4 && strncmp(p, "null", 4) == 0) {
+                p += 4;
+            } else {
+                int64_t value;
+                p = parseInteger(p, end, METRICS_FIELD_UNSIGNED[index], value);
+                if (p == nullptr) {
+                    return false;
+                }
+                metricsSetField(parsed, index, value);
+            }
+        } else {
+            // Unknown keys may hold any value
+            const char* value = p;
+            p = skipValue(p, end);
+            if (p == nullptr || p == value) {
+                return false;
+            }
+        }
+
+        p = skipSpace(p, end);
+        if (p >= end) {
+            return false;
+        }
+        if (*p == '}') {
+            return finishObject(p, end, parsed, data);
+        }
+        if (*p != ',') {
+            return false;
+        }
+        p = skipSpace(p + 1, end);
+    }
+    return false;
+}
+
+int writeMetricsJson(char* out, size_t size, const MetricsData &data) {
+    size_t used = 0;
+    for (uint8_t i = 0; i < METRICS_FIELD_TOTAL; i++) {
+        int32_t value = metricsGetField(data, i);
+        int len = METRICS_FIELD_UNSIGNED[i]
+            ? snprintf(out + used, size - used, "%c\"%s\":%lu", i == 0 ? '{' : ',',
+                       METRICS_FIELD_KEYS[i], (unsigned long)(uint32_t)value)
+            : snprintf(out + used, size - used, "%c\"%s\":%ld", i == 0 ? '{' : ',',
+                       METRICS_FIELD_KEYS[i], (long)value);
+        if (len < 0 || used + len + 1 >= size) {
+            return -1;
+        }
+        used += len;
+    }
+    out[used++] = '}';
+    out[used] = '\0';
+    return used;
+}
+
+int32_t metricFieldValue(MetricField field, const MetricsData &data, int rssi) {
+    if (field == FIELD_RSSI) {
+        return rssi;
+    }
+    if (field > FIELD_NONE && field < FIELD_RSSI) {
+        return metricsGetField(data, field - 1);
+    }
+    return 0;
+}
+
+bool metricFieldFromName(const char* name, MetricField &field) {
+    for (uint8_t i = FIELD_NONE + 1; i < FIELD_COUNT; i++) {
+        if (strcmp(FIELD_NAMES[i], name) == 0) {
+            field = static_cast<MetricField>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* metricFieldName(MetricField field) {
+    return (field < FIELD_COUNT) ? FIELD_NAMES[field] : "";
+}
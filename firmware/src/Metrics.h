@@ -0,0 +1,48 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include "MetricsSchema.h"
+
+// MetricsData and the wire field list are generated from
+// protocol/metrics.schema.json; run `task generate` after editing it.
+
+// Addressable metric fields, shared by the layout engine and alert rules.
+// Names in layout/alert files use the protocol keys.
+enum MetricField : uint8_t {
+    FIELD_NONE,
+#define METRICS_FIELD_ENUM(name, member, key, since) FIELD_##name,
+    METRICS_FIELDS(METRICS_FIELD_ENUM)
+#undef METRICS_FIELD_ENUM
+    FIELD_RSSI,      // rssi (not part of MetricsData, supplied by caller)
+    FIELD_COUNT
+};
+
+// Binary snapshot (LAN mirror body and multicast datagram payload):
+// 'A' 'M' version epoch | sequence | one little-endian 32-bit word per
+// field in schema order. Older versions carry a prefix of the fields.
+#define METRICS_SNAPSHOT_HEADER_SIZE 8
+#define METRICS_SNAPSHOT_SIZE (METRICS_SNAPSHOT_HEADER_SIZE + 4 * METRICS_FIELD_TOTAL)
+#define METRICS_SNAPSHOT_VERSION METRICS_SCHEMA_VERSION
+// Multicast datagram: snapshot followed by CRC32 of the snapshot. Sized for
+// the generator's field limit, so newer servers with extra fields still decode.
+#define METRICS_DATAGRAM_MAX_SIZE (METRICS_SNAPSHOT_HEADER_SIZE + 4 * 32 + 4)
+
+// The epoch is a random non-zero byte picked when the sender starts, so a
+// restart is recognizable even when its sequence overlaps the old one.
+// 0 means the sender does not set one.
+void encodeMetricsSnapshot(uint8_t* out, uint8_t epoch, uint32_t sequence, const MetricsData &data);
+bool decodeMetricsSnapshot(const uint8_t* in, size_t len, uint8_t &epoch, uint32_t &sequence, MetricsData &data);
+
+// Compact JSON in the upstream protocol format. parseMetricsJson skips keys it
+// does not know and leaves fields missing from older servers (or null) at
+// zero. It fails on a known key whose value is not a plain integer in the
+// field's 32-bit range, and on anything after the closing brace.
+bool parseMetricsJson(const char* json, size_t len, MetricsData &data);
+int writeMetricsJson(char* out, size_t size, const MetricsData &data);
+
+int32_t metricFieldValue(MetricField field, const MetricsData &data, int rssi);
+bool metricFieldFromName(const char* name, MetricField &field);
+const char* metricFieldName(MetricField field);
+
+#endif // METRICS_H
@@ -1,8 +1,22 @@
 #include "MetricsClient.h"
 #include "Config.h"
-#include <ArduinoJson.h>
+#include "Crc32.h"
+#include <ESP8266WiFi.h>
 
-MetricsClient::MetricsClient(const char* serverUrl) : failureCount(0) {
+// Response header carrying the sequence of the snapshot served over HTTP
+static const char* const SEQUENCE_HEADER = "X-Metrics-Seq";
+// Request header naming the newest schema version this firmware understands
+static const char* const SCHEMA_HEADER = "X-Metrics-Schema";
+
+MetricsClient::MetricsClient()
+    : failureCount(0), multicastActive(false), haveSequence(false), catchUpPending(false),
+      lastEpoch(0), lastSequence(0), gapCount(0), lastDatagramAt(0) {
+    baseUrl[0] = '\0';
+}
+
+MetricsClient::MetricsClient(const char* serverUrl)
+    : failureCount(0), multicastActive(false), haveSequence(false), catchUpPending(false),
+      lastEpoch(0), lastSequence(0), gapCount(0), lastDatagramAt(0) {
     strncpy(baseUrl, serverUrl, sizeof(baseUrl) - 1);
     baseUrl[sizeof(baseUrl) - 1] = '\0';
 }
@@ -18,11 +32,18 @@ bool MetricsClient::fetchMetrics(MetricsData &data) {
         return false;
     }
     
+    // Any fetch, successful or not, settles a pending catch-up
+    catchUpPending = false;
+    
     char url[160];
     snprintf(url, sizeof(url), "%s/api/v1/metrics", baseUrl);
     
     http.begin(wifiClient, url);
     http.setTimeout(HTTP_TIMEOUT_MS);
+    http.addHeader(SCHEMA_HEADER, String(METRICS_SCHEMA_VERSION));
+    
+    const char* headerKeys[] = { SEQUENCE_HEADER };
+    http.collectHeaders(headerKeys, 1);
     
     int httpCode = http.GET();
     
@@ -50,12 +71,19 @@ bool MetricsClient::fetchMetrics(MetricsData &data) {
     int len = stream->readBytes(buffer, contentLength);
     buffer[len] = '\0';
     
+    // Servers that also multicast report which snapshot this is
+    String sequence = http.header(SEQUENCE_HEADER);
+    
     http.end();
     
-    bool success = parseMetrics(buffer, data);
+    bool success = parseMetrics(buffer, len, data);
     
     if (success) {
         failureCount = 0;
+        if (sequence.length() > 0) {
+            lastSequence = strtoul(sequence.c_str(), nullptr, 10);
+            haveSequence = true;
+        }
     } else {
         failureCount++;
     }
@@ -63,24 +91,107 @@ bool MetricsClient::fetchMetrics(MetricsData &data) {
     return success;
 }
 
-bool MetricsClient::parseMetrics(const char* json, MetricsData &data) {
-    StaticJsonDocument<METRICS_JSON_SIZE> doc;
+bool MetricsClient::parseMetrics(const char* json, size_t len, MetricsData &data) {
+    if (!parseMetricsJson(json, len, data)) {
+        Serial.println(F("JSON parse error"));
+        return false;
+    }
+    
+    return true;
+}
+
+bool MetricsClient::beginMulticast() {
+#if MULTICAST_ENABLED
+    IPAddress group(MULTICAST_GROUP);
+    multicastActive = udp.beginMulticast(WiFi.localIP(), group, MULTICAST_PORT);
     
-    DeserializationError error = deserializeJson(doc, json);
-    if (error) {
-        Serial.print(F("JSON parse error: "));
-        Serial.println(error.c_str());
+    if (multicastActive) {
+        Serial.print(F("Listening for multicast on port "));
+        Serial.println(MULTICAST_PORT);
+    } else {
+        Serial.println(F("Multicast join failed, using HTTP polling"));
+    }
+#endif
+    return multicastActive;
+}
+
+bool MetricsClient::isMulticastLive() const {
+    return multicastActive && lastDatagramAt != 0 &&
+           millis() - lastDatagramAt < MULTICAST_TIMEOUT_MS;
+}
+
+bool MetricsClient::pollMulticast(MetricsData &data) {
+    if (!multicastActive) {
         return false;
     }
     
-    // Parse all fields
-    data.status = doc["s"] | 0;
-    data.latency = doc["l"] | 0;
-    data.activeTriangles = doc["a"] | 0;
-    data.bestArb = doc["b"] | 0;
-    data.pnl = doc["p"] | 0;
-    data.errors = doc["e"] | 0;
-    data.timestamp = doc["ts"] | 0;
+    bool applied = false;
     
-    return true;
+    // Drain everything queued since the last loop; the newest snapshot wins
+    while (udp.parsePacket() > 0) {
+        uint8_t packet[METRICS_DATAGRAM_MAX_SIZE];
+        int len = udp.read(packet, sizeof(packet));
+        
+        // Length varies with the sender's schema version
+        if (len < METRICS_SNAPSHOT_HEADER_SIZE + 4 || udp.available() > 0) {
+            udp.flush();
+            continue;
+        }
+        
+        size_t snapshotLen = len - 4;
+        uint32_t crc = (uint32_t)packet[snapshotLen] |
+                       ((uint32_t)packet[snapshotLen + 1] << 8) |
+                       ((uint32_t)packet[snapshotLen + 2] << 16) |
+                       ((uint32_t)packet[snapshotLen + 3] << 24);
+        if (crc != crc32(packet, snapshotLen)) {
+            continue;
+        }
+        
+        uint8_t epoch;
+        uint32_t sequence;
+        MetricsData snapshot;
+        if (!decodeMetricsSnapshot(packet, snapshotLen, epoch, sequence, snapshot)) {
+            continue;
+        }
+        
+        lastDatagramAt = millis();
+        
+        if (haveSequence) {
+            int32_t step = (int32_t)(sequence - lastSequence);
+            
+            // A new epoch is a server restart, however its sequence compares.
+            // Senders without one (epoch 0) restart when the sequence jumps far
+            // back, or steps back carrying other data than we are showing.
+            bool restarted;
+            if (epoch != 0 && lastEpoch != 0) {
+                restarted = epoch != lastEpoch;
+            } else {
+                restarted = step <= -MULTICAST_RESTART_WINDOW ||
+                            (step <= 0 && memcmp(&snapshot, &data, sizeof(snapshot)) != 0);
+            }
+            
+            // Heartbeat of the snapshot we already have, or a late duplicate
+            if (step <= 0 && !restarted) {
+                continue;
+            }
+            
+            // Missed datagrams, or the server restarted its sequence
+            if (step != 1 || restarted) {
+                gapCount++;
+                catchUpPending = true;
+            }
+        }
+        
+        lastEpoch = epoch;
+        lastSequence = sequence;
+        haveSequence = true;
+        data = snapshot;
+        applied = true;
+    }
+    
+    if (applied) {
+        failureCount = 0;
+    }
+    
+    return applied;
 }
@@ -1,19 +1,32 @@
 #ifndef METRICS_CLIENT_H
 #define METRICS_CLIENT_H
 
-#include "Display.h"
+#include "Metrics.h"
 #include <ESP8266HTTPClient.h>
 #include <WiFiClient.h>
+#include <WiFiUdp.h>
 
 class MetricsClient {
 public:
-    MetricsClient() : failureCount(0) { baseUrl[0] = '\0'; }
+    MetricsClient();
     MetricsClient(const char* serverUrl);
     
     void setServerUrl(const char* serverUrl);
     bool fetchMetrics(MetricsData &data);
     int getFailureCount() const { return failureCount; }
     void resetFailureCount() { failureCount = 0; }
+    
+    // Multicast push: the server sends each changed snapshot once to the
+    // group, plus periodic heartbeats of the latest one. Call beginMulticast()
+    // after every WiFi (re)connect.
+    bool beginMulticast();
+    // Applies pending datagrams; returns true if a new snapshot was applied
+    bool pollMulticast(MetricsData &data);
+    // A datagram arrived within MULTICAST_TIMEOUT_MS; HTTP polling can pause
+    bool isMulticastLive() const;
+    // A sequence gap was seen; one HTTP fetch should resynchronize
+    bool isCatchUpPending() const { return catchUpPending; }
+    uint32_t getGapCount() const { return gapCount; }
 
 private:
     char baseUrl[128];
@@ -21,7 +34,16 @@ private:
     WiFiClient wifiClient;
     HTTPClient http;
     
-    bool parseMetrics(const char* json, MetricsData &data);
+    WiFiUDP udp;
+    bool multicastActive;
+    bool haveSequence;
+    bool catchUpPending;
+    uint8_t lastEpoch;
+    uint32_t lastSequence;
+    uint32_t gapCount;
+    unsigned long lastDatagramAt;
+    
+    bool parseMetrics(const char* json, size_t len, MetricsData &data);
 };
 
 #endif // METRICS_CLIENT_H
@@ -0,0 +1,99 @@
+// Code generated by protocol/gen from protocol/metrics.schema.json. DO NOT EDIT.
+
+#ifndef METRICS_SCHEMA_H
+#define METRICS_SCHEMA_H
+
+#include <Arduino.h>
+
+#define METRICS_SCHEMA_VERSION 1
+#define METRICS_FIELD_TOTAL 7
+#define METRICS_JSON_MAX_SIZE 114  // Worst case, current version
+
+struct MetricsData {
+    int status;          // s: 1=ok, 0=down
+    int latency;         // l: ms
+    int activeTriangles; // a: count
+    int bestArb;         // b: percentage × 100
+    int pnl;             // p: cents
+    int errors;          // e: count
+    uint32_t timestamp;  // ts: epoch seconds (uint32_t for consistency, valid until year 2106)
+};
+
+// X(ENUM, member, key, since) in wire order; new fields are only appended
+#define METRICS_FIELDS(X) \
+    X(STATUS, status, "s", 1) \
+    X(LATENCY, latency, "l", 1) \
+    X(ACTIVE, activeTriangles, "a", 1) \
+    X(BEST_ARB, bestArb, "b", 1) \
+    X(PNL, pnl, "p", 1) \
+    X(ERRORS, errors, "e", 1) \
+    X(TIMESTAMP, timestamp, "ts", 1)
+
+static constexpr const char* METRICS_FIELD_KEYS[METRICS_FIELD_TOTAL] = { "s", "l", "a", "b", "p", "e", "ts" };
+static constexpr uint8_t METRICS_FIELD_SINCE[METRICS_FIELD_TOTAL] = { 1, 1, 1, 1, 1, 1, 1 };
+static constexpr bool METRICS_FIELD_UNSIGNED[METRICS_FIELD_TOTAL] = { false, false, false, false, false, false, true };
+
+// Number of fields carried by a given schema version (fields are a prefix)
+constexpr uint8_t metricsFieldCount(uint8_t version) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < METRICS_FIELD_TOTAL; i++) {
+        if (METRICS_FIELD_SINCE[i] <= version) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Field index for a JSON key, or -1 for keys this firmware does not know
+constexpr int metricsKeyIndex(const char* key, size_t len) {
+    switch (len) {
+        case 1:
+            if (key[0] == 's') return 0;
+            if (key[0] == 'l') return 1;
+            if (key[0] == 'a') return 2;
+            if (key[0] == 'b') return 3;
+            if (key[0] == 'p') return 4;
+            if (key[0] == 'e') return 5;
+            break;
+        case 2:
+            if (key[0] == 't' && key[1] == 's') return 6;
+            break;
+    }
+    return -1;
+}
+
+static_assert(metricsKeyIndex("s", 1) == 0, "key dispatch");
+static_assert(metricsKeyIndex("l", 1) == 1, "key dispatch");
+static_assert(metricsKeyIndex("a", 1) == 2, "key dispatch");
+static_assert(metricsKeyIndex("b", 1) == 3, "key dispatch");
+static_assert(metricsKeyIndex("p", 1) == 4, "key dispatch");
+static_assert(metricsKeyIndex("e", 1) == 5, "key dispatch");
+static_assert(metricsKeyIndex("ts", 2) == 6, "key dispatch");
+
+inline int32_t metricsGetField(const MetricsData &data, uint8_t index) {
+    switch (index) {
+        case 0: return (int32_t)data.status;
+        case 1: return (int32_t)data.latency;
+        case 2: return (int32_t)data.activeTriangles;
+        case 3: return (int32_t)data.bestArb;
+        case 4: return (int32_t)data.pnl;
+        case 5: return (int32_t)data.errors;
+        case 6: return (int32_t)data.timestamp;
+        default: return 0;
+    }
+}
+
+inline void metricsSetField(MetricsData &data, uint8_t index, int64_t value) {
+    switch (index) {
+        case 0: data.status = (int)value; break;
+        case 1: data.latency = (int)value; break;
+        case 2: data.activeTriangles = (int)value; break;
+        case 3: data.bestArb = (int)value; break;
+        case 4: data.pnl = (int)value; break;
+        case 5: data.errors = (int)value; break;
+        case 6: data.timestamp = (uint32_t)value; break;
+        default: break;
+    }
+}
+
+#endif // METRICS_SCHEMA_H
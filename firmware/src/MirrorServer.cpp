@@ -0,0 +1,133 @@
+#include "MirrorServer.h"
+
+// Self-refreshing view; polls the JSON endpoint so the page itself is static.
+// Not generated: rows and formatting are per key, so new schema fields must be
+// added here by hand.
+static const char MIRROR_HTML[] PROGMEM =
+    "<!DOCTYPE html><html><head><title>ARB Dashboard</title>"
+    "<meta name='viewport' content='width=device-width,initial-scale=1'>"
+    "<style>"
+    "body{font-family:Arial,sans-serif;margin:20px;background:#111;color:#eee}"
+    ".container{max-width:400px;margin:0 auto}"
+    "h1{color:#ffe000;text-align:center}"
+    "table{width:100%;font-size:20px}td:last-child{text-align:right;font-family:monospace}"
+    ".ok{color:#0f0}.bad{color:#f33}"
+    "</style></head><body><div class='container'>"
+    "<h1>ARB Dashboard</h1><table>"
+    "<tr><td>Bot</td><td id='s'>-</td></tr>"
+    "<tr><td>Latency</td><td id='l'>-</td></tr>"
+    "<tr><td>Active</td><td id='a'>-</td></tr>"
+    "<tr><td>Best %</td><td id='b'>-</td></tr>"
+    "<tr><td>PNL</td><td id='p'>-</td></tr>"
+    "<tr><td>Errors</td><td id='e'>-</td></tr>"
+    "</table><p id='u'></p></div><script>"
+    "function $(i){return document.getElementById(i)}"
+    "function t(){fetch('/api/v1/metrics').then(function(r){if(!r.ok)throw 0;return r.json()})"
+    ".then(function(m){$('s').textContent=m.s?'OK':'DOWN';$('s').className=m.s?'ok':'bad';"
+    "$('l').textContent=m.l+' ms';$('a').textContent=m.a;"
+    "$('b').textContent=(m.b/100).toFixed(2)+'%';"
+    "$('p').textContent=(m.p<0?'-$':'$')+(Math.abs(m.p)/100).toFixed(2);"
+    "$('p').className=m.p<0?'bad':'ok';$('e').textContent=m.e;"
+    "$('u').textContent='Updated '+new Date(m.ts*1000).toLocaleTimeString()})"
+    ".catch(function(){$('s').textContent='NO DATA';$('s').className='bad'})}"
+    "t();setInterval(t,2000)"
+    "</script></body></html>";
+
+MirrorServer::MirrorServer()
+    : server(MIRROR_HTTP_PORT), active(false), available(false), epoch(0), sequence(0), power(nullptr), lastRequestAt(0), jsonLength(0) {
+    jsonBuffer[0] = '\0';
+    memset(binaryBuffer, 0, sizeof(binaryBuffer));
+}
+
+void MirrorServer::begin() {
+    if (active) {
+        return;
+    }
+
+    // New epoch per boot, so readers can tell a reset sequence from a stale one
+    epoch = (ESP.random() % 255) + 1;
+
+    server.on("/", HTTP_GET, [this]() { this->handleRoot(); });
+    server.on("/api/v1/metrics", HTTP_GET, [this]() { this->handleJson(); });
+    server.on("/api/v1/metrics.bin", HTTP_GET, [this]() { this->handleBinary(); });
+    server.on("/api/v1/power", HTTP_GET, [this]() { this->handlePower(); });
+
+    server.begin();
+    active = true;
+
+    Serial.print(F("LAN mirror on port "));
+    Serial.println(MIRROR_HTTP_PORT);
+}
+
+void MirrorServer::handleClient() {
+    if (active) {
+        server.handleClient();
+    }
+}
+
+bool MirrorServer::hasRecentClients() const {
+    return lastRequestAt != 0 && millis() - lastRequestAt < MIRROR_CLIENT_WINDOW_MS;
+}
+
+void MirrorServer::publish(const MetricsData &data) {
+    sequence++;
+
+    // Same keys as the upstream protocol, so the mirror is itself a valid server
+    int len = writeMetricsJson(jsonBuffer, sizeof(jsonBuffer), data);
+
+    if (len < 0) {
+        available = false;
+        return;
+    }
+    jsonLength = len;
+
+    encodeMetricsSnapshot(binaryBuffer, epoch, sequence, data);
+
+    available = true;
+}
+
+void MirrorServer::handleRoot() {
+    lastRequestAt = millis();
+    server.send_P(200, "text/html", MIRROR_HTML);
+}
+
+void MirrorServer::handleJson() {
+    lastRequestAt = millis();
+    if (!available) {
+        sendUnavailable();
+        return;
+    }
+
+    server.sendHeader("Cache-Control", "no-store");
+    server.send(200, "application/json", jsonBuffer, jsonLength);
+}
+
+void MirrorServer::handleBinary() {
+    lastRequestAt = millis();
+    if (!available) {
+        sendUnavailable();
+        return;
+    }
+
+    server.sendHeader("Cache-Control", "no-store");
+    server.send(200, "application/octet-stream",
+                reinterpret_cast<const char*>(binaryBuffer), sizeof(binaryBuffer));
+}
+
+void MirrorServer::handlePower() {
+    lastRequestAt = millis();
+    // Diagnostics only, so this one is serialized per request
+    char json[160];
+    if (power == nullptr || power->formatStats(json, sizeof(json)) == 0) {
+        sendUnavailable();
+        return;
+    }
+
+    server.sendHeader("Cache-Control", "no-store");
+    server.send(200, "application/json", json);
+}
+
+void MirrorServer::sendUnavailable() {
+    // Matches the upstream contract for "no valid metrics"
+    server.send(503, "text/plain", "No data");
+}
@@ -0,0 +1,49 @@
+#ifndef MIRROR_SERVER_H
+#define MIRROR_SERVER_H
+
+#include "Config.h"
+#include "Metrics.h"
+#include "PowerManager.h"
+#include <ESP8266WebServer.h>
+
+// Serves the latest MetricsData to other LAN clients in station mode, so
+// extra viewers never add load on the bot. Responses are serialized once per
+// publish() into static buffers; request handlers only send those bytes.
+class MirrorServer {
+public:
+    MirrorServer();
+
+    void begin();
+    void handleClient();
+    void attachPower(const PowerManager* manager) { power = manager; }
+    bool isActive() const { return active; }
+    // A request arrived within MIRROR_CLIENT_WINDOW_MS; the first request
+    // after a quiet period waits for the next loop deadline
+    bool hasRecentClients() const;
+
+    // Call after every successful fetch
+    void publish(const MetricsData &data);
+    // Call when the upstream data can no longer be trusted
+    void invalidate() { available = false; }
+
+private:
+    ESP8266WebServer server;
+    bool active;
+    bool available;
+    uint8_t epoch;
+    uint32_t sequence;
+    const PowerManager* power;
+    unsigned long lastRequestAt;
+
+    char jsonBuffer[METRICS_JSON_SIZE];
+    size_t jsonLength;
+    uint8_t binaryBuffer[METRICS_SNAPSHOT_SIZE];
+
+    void handleRoot();
+    void handleJson();
+    void handleBinary();
+    void handlePower();
+    void sendUnavailable();
+};
+
+#endif // MIRROR_SERVER_H
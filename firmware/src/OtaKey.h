@@ -0,0 +1,12 @@
+#ifndef OTA_KEY_H
+#define OTA_KEY_H
+
+#include <Arduino.h>
+
+// RSA public key that OTA images must be signed with. Generate a key pair
+// with `task ota-keygen` and paste ota/public.key between the delimiters.
+// While this is empty the device never downloads an image.
+static const char OTA_PUBLIC_KEY[] PROGMEM = R"KEY(
+)KEY";
+
+#endif // OTA_KEY_H
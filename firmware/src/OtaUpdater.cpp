@@ -0,0 +1,334 @@
+#include "OtaUpdater.h"
+#include "OtaKey.h"
+#include "Crc32.h"
+#include <ArduinoJson.h>
+#include <Updater.h>
+
+// Request headers identifying this device to the update server
+static const char* const DEVICE_ID_HEADER = "X-Device-Id";
+static const char* const BUILD_HEADER = "X-Firmware-Build";
+
+OtaUpdater::OtaUpdater()
+    : keyLoaded(false), state(OTA_IDLE), nextCheckAt(0), startedAt(0), lastDataAt(0),
+      retryDelayMs(OTA_RETRY_MIN_MS), targetBuild(0), failedBuild(0), imageSize(0), received(0),
+      signingVerifier(&signingKey) {
+    baseUrl[0] = '\0';
+    deviceId[0] = '\0';
+}
+
+void OtaUpdater::begin(const char* serverUrl) {
+    strncpy(baseUrl, serverUrl, sizeof(baseUrl) - 1);
+    baseUrl[sizeof(baseUrl) - 1] = '\0';
+    snprintf(deviceId, sizeof(deviceId), "%06x", (unsigned int)ESP.getChipId());
+    nextCheckAt = millis() + OTA_FIRST_CHECK_MS;
+
+#if OTA_ENABLED
+    // An unnumbered build would take any manifest build as newer and
+    // reinstall it on every boot
+    if (FIRMWARE_BUILD == 0) {
+        Serial.println(F("OTA disabled: built without -DFIRMWARE_BUILD"));
+        return;
+    }
+
+    if (!keyLoaded) {
+        // Update.end() refuses any image whose signature does not verify
+        keyLoaded = signingKey.parse(OTA_PUBLIC_KEY);
+        if (keyLoaded) {
+            Update.installSignature(&signingHash, &signingVerifier);
+        } else {
+            Serial.println(F("OTA disabled: no signing key in OtaKey.h"));
+        }
+    }
+#endif
+}
+
+void OtaUpdater::service() {
+#if OTA_ENABLED
+    if (state == OTA_DOWNLOADING) {
+        pump();
+        return;
+    }
+
+    // Signed difference handles millis() rollover
+    if (!keyLoaded || baseUrl[0] == '\0' || (long)(millis() - nextCheckAt) < 0) {
+        return;
+    }
+
+    checkManifest();
+#endif
+}
+
+uint8_t OtaUpdater::progressPercent() const {
+    return imageSize > 0 ? (uint8_t)((uint64_t)received * 100 / imageSize) : 0;
+}
+
+void OtaUpdater::buildUrl(char* url, size_t size, const char* path) const {
+    // Absolute image URLs are used as-is; paths are relative to the server
+    if (strncmp(path, "http://", 7) == 0) {
+        snprintf(url, size, "%s", path);
+    } else {
+        snprintf(url, size, "%s%s", baseUrl, path);
+    }
+}
+
+void OtaUpdater::addDeviceHeaders() {
+    http.addHeader(DEVICE_ID_HEADER, deviceId);
+    http.addHeader(BUILD_HEADER, String(FIRMWARE_BUILD));
+}
+
+bool OtaUpdater::inRollout(uint8_t percent) const {
+    // Stable per-device bucket, so raising the percentage only adds devices
+    uint32_t bucket = crc32(reinterpret_cast<const uint8_t*>(deviceId), strlen(deviceId)) % 100;
+    return bucket < percent;
+}
+
+void OtaUpdater::checkManifest() {
+    nextCheckAt = millis() + OTA_CHECK_INTERVAL_MS;
+
+    char url[160];
+    buildUrl(url, sizeof(url), OTA_MANIFEST_PATH);
+
+    http.begin(wifiClient, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    addDeviceHeaders();
+
+    int httpCode = http.GET();
+
+    // No manifest simply means no rollout is in progress
+    if (httpCode != HTTP_CODE_OK) {
+        if (httpCode != HTTP_CODE_NOT_FOUND) {
+            Serial.print(F("OTA manifest error: "));
+            Serial.println(httpCode);
+        }
+        http.end();
+        return;
+    }
+
+    int contentLength = http.getSize();
+    if (contentLength < 0 || contentLength >= OTA_MANIFEST_JSON_SIZE) {
+        Serial.print(F("OTA manifest too large or size unknown: "));
+        Serial.println(contentLength);
+        http.end();
+        return;
+    }
+
+    // The chunk buffer is idle between downloads, so the manifest borrows it
+    static_assert(OTA_MANIFEST_JSON_SIZE <= OTA_CHUNK_SIZE, "Manifest must fit the chunk buffer");
+    char* buffer = reinterpret_cast<char*>(chunk);
+    int len = http.getStreamPtr()->readBytes(buffer, contentLength);
+    http.end();
+
+    // Parsed in place; strings in the document point into the buffer
+    StaticJsonDocument<OTA_MANIFEST_JSON_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, buffer, len);
+    if (error) {
+        Serial.print(F("OTA manifest parse error: "));
+        Serial.println(error.c_str());
+        return;
+    }
+
+    uint32_t build = doc["build"] | 0;
+    const char* image = doc["image"] | "";
+    int rollout = doc["rollout"] | 0;
+
+    if (build <= FIRMWARE_BUILD || build == failedBuild || image[0] == '\0') {
+        return;
+    }
+
+    // Devices listed by ID (canaries) update regardless of the percentage
+    bool listed = false;
+    for (JsonVariantConst id : doc["devices"].as<JsonArrayConst>()) {
+        if (strcmp(id | "", deviceId) == 0) {
+            listed = true;
+        }
+    }
+
+    if (!listed && !inRollout(constrain(rollout, 0, 100))) {
+        Serial.print(F("OTA: build "));
+        Serial.print(build);
+        Serial.println(F(" not rolled out to this device yet"));
+        return;
+    }
+
+    // A new build starts its retries from the shortest delay again
+    if (build != targetBuild) {
+        retryDelayMs = OTA_RETRY_MIN_MS;
+    }
+    targetBuild = build;
+    startDownload(image);
+}
+
+void OtaUpdater::startDownload(const char* image) {
+    imageSize = 0;
+    received = 0;
+    startedAt = millis();
+
+    char url[160];
+    buildUrl(url, sizeof(url), image);
+
+    Serial.print(F("OTA: downloading build "));
+    Serial.print(targetBuild);
+    Serial.print(F(" from "));
+    Serial.println(url);
+
+    http.begin(wifiClient, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    addDeviceHeaders();
+
+    int httpCode = http.GET();
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.print(F("OTA image HTTP error: "));
+        Serial.println(httpCode);
+        fail("image request failed");
+        return;
+    }
+
+    // The partition is sized up front, so the server must send a length
+    int contentLength = http.getSize();
+    if (contentLength <= 0) {
+        fail("image size unknown");
+        return;
+    }
+
+    if (!Update.begin(contentLength)) {
+        fail(Update.getErrorString().c_str());
+        return;
+    }
+
+    imageSize = contentLength;
+    lastDataAt = millis();
+    state = OTA_DOWNLOADING;
+}
+
+void OtaUpdater::pump() {
+    WiFiClient* stream = http.getStreamPtr();
+    unsigned long sliceStart = millis();
+
+    // Move whatever the socket holds, one chunk at a time, until the slice
+    // is used up; the Updater buffers a flash sector and writes it when full
+    while (received < imageSize && millis() - sliceStart < OTA_SLICE_MS) {
+        size_t available = stream->available();
+        if (available == 0) {
+            if (!stream->connected()) {
+                fail("connection closed");
+                return;
+            }
+            break;
+        }
+
+        size_t want = min(min(available, sizeof(chunk)), imageSize - received);
+        size_t len = stream->readBytes(chunk, want);
+        if (len == 0 || Update.write(chunk, len) != len) {
+            fail(Update.hasError() ? Update.getErrorString().c_str() : "read failed");
+            return;
+        }
+
+        received += len;
+        lastDataAt = millis();
+    }
+
+    if (received >= imageSize) {
+        finish();
+    } else if (millis() - lastDataAt >= OTA_STALL_TIMEOUT_MS) {
+        fail("download stalled");
+    }
+}
+
+void OtaUpdater::finish() {
+    http.end();
+
+    // Checks the signature over the written image before marking it bootable
+    if (!Update.end()) {
+        fail(Update.getErrorString().c_str(), true);
+        return;
+    }
+
+    unsigned long elapsed = millis() - startedAt;
+    Serial.print(F("OTA: "));
+    Serial.print((unsigned long)received);
+    Serial.print(F(" bytes in "));
+    Serial.print(elapsed);
+    Serial.println(F(" ms, verified, rebooting"));
+
+    report(true, nullptr);
+    delay(100);
+    ESP.restart();
+}
+
+void OtaUpdater::fail(const char* reason, bool rejected) {
+    Serial.print(F("OTA failed: "));
+    Serial.println(reason);
+
+    http.end();
+    if (Update.isRunning()) {
+        // Ending an unfinished update discards it; the running image stays
+        Update.end();
+    }
+
+    if (rejected) {
+        // The image itself is bad: skip this build until the manifest moves
+        // on or the device reboots
+        failedBuild = targetBuild;
+        retryDelayMs = OTA_RETRY_MIN_MS;
+    } else {
+        // Network trouble: try again sooner than the regular check, backing
+        // off while it keeps failing
+        nextCheckAt = millis() + retryDelayMs;
+        retryDelayMs = min(retryDelayMs * 2, OTA_CHECK_INTERVAL_MS);
+    }
+    state = OTA_IDLE;
+    report(false, reason);
+}
+
+// Copies text into a JSON string body, escaping quotes, backslashes and
+// control characters; truncates rather than splitting an escape
+static void escapeJson(char* out, size_t size, const char* text) {
+    size_t used = 0;
+    for (; *text != '\0'; text++) {
+        char c = *text;
+        char escaped[7];
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = c;
+            escaped[2] = '\0';
+        } else if ((uint8_t)c < 0x20) {
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)c);
+        } else {
+            escaped[0] = c;
+            escaped[1] = '\0';
+        }
+        size_t len = strlen(escaped);
+        if (used + len >= size) {
+            break;
+        }
+        memcpy(out + used, escaped, len);
+        used += len;
+    }
+    out[used] = '\0';
+}
+
+void OtaUpdater::report(bool ok, const char* error) {
+    char url[160];
+    buildUrl(url, sizeof(url), OTA_REPORT_PATH);
+
+    // Error strings come from HTTP and the Updater and may contain anything
+    char escapedError[96];
+    escapeJson(escapedError, sizeof(escapedError), error != nullptr ? error : "");
+
+    char body[192];
+    int len = snprintf(body, sizeof(body),
+        "{\"target\":%lu,\"ok\":%s,\"bytes\":%lu,\"ms\":%lu,\"error\":\"%s\"}",
+        (unsigned long)targetBuild, ok ? "true" : "false", (unsigned long)received,
+        (unsigned long)(millis() - startedAt), escapedError);
+    if (len < 0 || (size_t)len >= sizeof(body)) {
+        return;
+    }
+
+    // Best effort; the server also tracks progress from the bytes it sent
+    http.begin(wifiClient, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    addDeviceHeaders();
+    http.addHeader("Content-Type", "application/json");
+    http.POST(reinterpret_cast<uint8_t*>(body), len);
+    http.end();
+}
@@ -0,0 +1,67 @@
+#ifndef OTA_UPDATER_H
+#define OTA_UPDATER_H
+
+#include "Config.h"
+#include <BearSSLHelpers.h>
+#include <ESP8266HTTPClient.h>
+#include <WiFiClient.h>
+
+enum OtaState : uint8_t {
+    OTA_IDLE,         // Waiting for the next manifest check
+    OTA_DOWNLOADING   // Streaming an image into the update partition
+};
+
+// Pulls signed, gzip-compressed firmware images from the metrics server.
+// A manifest names the newest build and which part of the fleet gets it;
+// the image is then streamed into the update partition a chunk at a time
+// from service(), so the dashboard keeps rendering during the download.
+// The compressed image is verified against OtaKey.h and inflated by the
+// bootloader on the next boot.
+class OtaUpdater {
+public:
+    OtaUpdater();
+
+    // Call once after WiFi connects
+    void begin(const char* serverUrl);
+    // Call every loop: checks the manifest when due, or moves the next slice
+    // of an active download. Reboots into the new image once it verifies.
+    void service();
+
+    bool isActive() const { return state == OTA_DOWNLOADING; }
+    uint8_t progressPercent() const;
+    const char* getDeviceId() const { return deviceId; }
+
+private:
+    char baseUrl[128];
+    char deviceId[9];
+    bool keyLoaded;
+    OtaState state;
+    unsigned long nextCheckAt;
+    unsigned long startedAt;
+    unsigned long lastDataAt;
+    unsigned long retryDelayMs;  // Wait before retrying after a transfer failure
+    uint32_t targetBuild;
+    uint32_t failedBuild;
+    size_t imageSize;
+    size_t received;
+
+    WiFiClient wifiClient;
+    HTTPClient http;
+    BearSSL::PublicKey signingKey;
+    BearSSL::HashSHA256 signingHash;
+    BearSSL::SigningVerifier signingVerifier;
+    uint8_t chunk[OTA_CHUNK_SIZE];
+
+    void checkManifest();
+    bool inRollout(uint8_t percent) const;
+    void startDownload(const char* image);
+    void pump();
+    void finish();
+    // rejected: the image failed verification and its build is not retried
+    void fail(const char* reason, bool rejected = false);
+    void report(bool ok, const char* error);
+    void buildUrl(char* url, size_t size, const char* path) const;
+    void addDeviceHeaders();
+};
+
+#endif // OTA_UPDATER_H
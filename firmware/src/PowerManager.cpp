@@ -0,0 +1,94 @@
+#include "PowerManager.h"
+#include "Config.h"
+#include <ESP8266WiFi.h>
+
+static const char* const MODE_NAMES[] = { "active", "modem", "light" };
+static const uint16_t STATE_MA[POWER_STATE_COUNT] = {
+    POWER_MA_AWAKE, POWER_MA_IDLE, POWER_MA_MODEM_SLEEP, POWER_MA_LIGHT_SLEEP
+};
+
+PowerManager::PowerManager() : mode(POWER_ACTIVE), lastWake(0) {
+    memset(totals, 0, sizeof(totals));
+}
+
+void PowerManager::begin(PowerMode powerMode) {
+    mode = powerMode;
+
+    switch (mode) {
+        case POWER_LIGHT_SLEEP:
+            WiFi.setSleepMode(WIFI_LIGHT_SLEEP, POWER_LISTEN_INTERVAL);
+            break;
+        case POWER_MODEM_SLEEP:
+            WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+            break;
+        default:
+            WiFi.setSleepMode(WIFI_NONE_SLEEP);
+            break;
+    }
+
+    Serial.print(F("Power mode: "));
+    Serial.println(MODE_NAMES[mode]);
+}
+
+PowerState PowerManager::idleState() const {
+    switch (mode) {
+        case POWER_LIGHT_SLEEP: return POWER_STATE_IDLE_LIGHT;
+        case POWER_MODEM_SLEEP: return POWER_STATE_IDLE_MODEM;
+        default:                return POWER_STATE_IDLE_ACTIVE;
+    }
+}
+
+void PowerManager::idleUntil(unsigned long deadline) {
+    unsigned long now = millis();
+    totals[POWER_STATE_AWAKE] += now - lastWake;
+
+    // Signed difference handles millis() rollover and already-passed deadlines
+    long remaining = min((long)(deadline - now), (long)POWER_MAX_IDLE_MS);
+
+    if (remaining > 0) {
+        // The SDK can only enter modem/light sleep while the CPU sits in delay()
+        delay((unsigned long)remaining);
+    } else {
+        yield();
+    }
+
+    unsigned long after = millis();
+    totals[idleState()] += after - now;
+    lastWake = after;
+}
+
+uint64_t PowerManager::stateMs(PowerState state) const {
+    uint64_t total = totals[state];
+    if (state == POWER_STATE_AWAKE) {
+        total += millis() - lastWake;
+    }
+    return total;
+}
+
+uint32_t PowerManager::estimatedMilliampsX100() const {
+    uint64_t elapsed = 0;
+    uint64_t charge = 0;  // mA × ms
+
+    for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) {
+        uint64_t ms = stateMs(static_cast<PowerState>(i));
+        elapsed += ms;
+        charge += ms * STATE_MA[i];
+    }
+
+    return (elapsed > 0) ? (uint32_t)(charge * 100 / elapsed) : 0;
+}
+
+size_t PowerManager::formatStats(char* buffer, size_t bufSize) const {
+    // Seconds keep the values within 32 bits for printf
+    int len = snprintf(buffer, bufSize,
+        "{\"mode\":\"%s\",\"awake_s\":%lu,\"idle_active_s\":%lu,\"idle_modem_s\":%lu,"
+        "\"idle_light_s\":%lu,\"est_ma_x100\":%lu}",
+        MODE_NAMES[mode],
+        (unsigned long)(stateMs(POWER_STATE_AWAKE) / 1000),
+        (unsigned long)(stateMs(POWER_STATE_IDLE_ACTIVE) / 1000),
+        (unsigned long)(stateMs(POWER_STATE_IDLE_MODEM) / 1000),
+        (unsigned long)(stateMs(POWER_STATE_IDLE_LIGHT) / 1000),
+        (unsigned long)estimatedMilliampsX100());
+
+    return (len > 0 && (size_t)len < bufSize) ? len : 0;
+}
@@ -0,0 +1,57 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+enum PowerMode : uint8_t {
+    POWER_ACTIVE,       // Radio always on
+    POWER_MODEM_SLEEP,  // Radio off between beacons, CPU idles in delay()
+    POWER_LIGHT_SLEEP   // SDK auto light sleep (CPU and radio) during delay()
+};
+
+enum PowerState : uint8_t {
+    POWER_STATE_AWAKE,        // Running loop() work: fetch, render, serve
+    // Time spent in delay() while each mode was configured. Whether the SDK
+    // actually slept during it is not observable, so these are not measurements.
+    POWER_STATE_IDLE_ACTIVE,
+    POWER_STATE_IDLE_MODEM,
+    POWER_STATE_IDLE_LIGHT,
+    POWER_STATE_COUNT
+};
+
+// Sleeps between the scheduled fetch and render deadlines and accounts for
+// time awake and time idle under each mode, so the current draw of a poll
+// interval can be estimated.
+class PowerManager {
+public:
+    PowerManager();
+
+    // Applies the sleep mode; call again after every WiFi (re)connect
+    void begin(PowerMode powerMode);
+    PowerMode getMode() const { return mode; }
+
+    // Replaces the fixed loop delay: idles until `deadline` (a millis()
+    // timestamp), or for at most POWER_MAX_IDLE_MS so the loop keeps serving
+    // the mirror and watching WiFi. Callers shorten the deadline when they
+    // need to be more responsive.
+    void idleUntil(unsigned long deadline);
+
+    // Milliseconds spent in a state since boot (awake includes time up to now)
+    uint64_t stateMs(PowerState state) const;
+
+    // Model-based average module current in mA × 100: state times weighted
+    // by the POWER_MA_* typical currents, not a measurement
+    uint32_t estimatedMilliampsX100() const;
+
+    // JSON summary for the mirror endpoint; returns length or 0 if it did not fit
+    size_t formatStats(char* buffer, size_t bufSize) const;
+
+private:
+    PowerMode mode;
+    unsigned long lastWake;
+    uint64_t totals[POWER_STATE_COUNT];
+
+    PowerState idleState() const;
+};
+
+#endif // POWER_MANAGER_H
@@ -41,6 +41,8 @@ void WiFiManager::startCaptivePortal(const char* apSSID) {
     // Setup web server routes
     server.on("/", [this]() { this->handleRoot(); });
     server.on("/save", HTTP_POST, [this]() { this->handleSave(); });
+    server.on("/config.json", HTTP_GET, [this]() { this->handleExport(); });
+    server.on("/config.json", HTTP_POST, [this]() { this->handleImport(); });
     server.onNotFound([this]() { this->handleNotFound(); });
     
     server.begin();
@@ -87,6 +89,50 @@ void WiFiManager::handleSave() {
     if (config.refresh_ms < MIN_REFRESH_MS) config.refresh_ms = MIN_REFRESH_MS;
     if (config.refresh_ms > MAX_REFRESH_MS) config.refresh_ms = MAX_REFRESH_MS;
     
+    saveAndRestart(config);
+}
+
+void WiFiManager::handleExport() {
+    AppConfig config;
+    
+    // Falls back to defaults if nothing has been stored yet
+    readStoredConfig(config);
+    
+    char json[CONFIG_JSON_SIZE + 128];
+    if (exportConfigJson(config, json, sizeof(json)) == 0) {
+        server.send(500, "text/plain", "Export failed");
+        return;
+    }
+    
+    server.sendHeader("Content-Disposition", "attachment; filename=config.json");
+    server.send(200, "application/json", json);
+}
+
+void WiFiManager::handleImport() {
+    AppConfig config;
+    bool hasPassword;
+    
+    // Raw request body is exposed by ESP8266WebServer as the "plain" arg
+    String body = server.arg("plain");
+    
+    if (!importConfigJson(body.c_str(), body.length(), config, hasPassword)) {
+        server.send(400, "text/plain", "Invalid config JSON");
+        return;
+    }
+    
+    // Exports carry no "pass" key; re-importing one keeps the stored password,
+    // while an explicit empty "pass" clears it (open network)
+    AppConfig stored;
+    if (!hasPassword && readStoredConfig(stored) &&
+        strcmp(stored.wifi.ssid, config.wifi.ssid) == 0) {
+        strncpy(config.wifi.password, stored.wifi.password, sizeof(config.wifi.password) - 1);
+        config.wifi.password[sizeof(config.wifi.password) - 1] = '\0';
+    }
+    
+    saveAndRestart(config);
+}
+
+void WiFiManager::saveAndRestart(const AppConfig &config) {
     // Validate and save
     if (validateConfig(config) && saveConfig(config)) {
         // Success response - use PROGMEM string
@@ -151,7 +197,10 @@ String WiFiManager::getSetupHTML() {
               "<label>Refresh Interval (ms):</label>"
               "<input type='number' name='refresh' min='1000' max='15000' value='3000'>"
               "<button type='submit'>Save & Reboot</button>"
-              "</form></div></body></html>");
+              "</form>"
+              "<div class='info'><a href='/config.json'>Export config.json</a> &middot; "
+              "import with <code>POST /config.json</code></div>"
+              "</div></body></html>");
     
     return html;
 }
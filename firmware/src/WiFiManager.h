@@ -22,8 +22,12 @@ private:
     
     void handleRoot();
     void handleSave();
+    void handleExport();
+    void handleImport();
     void handleNotFound();
     
+    void saveAndRestart(const AppConfig &config);
+    
     String getSetupHTML();
 };
 
@@ -2,21 +2,33 @@
 #include <LittleFS.h>
 #include "Config.h"
 #include "Display.h"
+#include "Layout.h"
+#include "AlertRules.h"
 #include "WiFiManager.h"
 #include "MetricsClient.h"
+#include "MirrorServer.h"
+#include "PowerManager.h"
+#include "OtaUpdater.h"
 
 // Global objects
 Display display;
 WiFiManager wifiManager;
 MetricsClient metricsClient;
+MirrorServer mirrorServer;
 AppConfig appConfig;
+Layout layout;
+AlertEngine alertEngine;
+PowerManager powerManager;
+OtaUpdater otaUpdater;
 
 // State variables
 unsigned long lastMetricsFetch = 0;
 unsigned long lastScreenRotation = 0;
-int currentScreen = 0;
+uint8_t currentScreen = 0;
 bool alertMode = false;
+bool redrawPending = true;
 MetricsData currentMetrics = {0};
+int16_t otaShownPercent = -1;  // Progress bar currently drawn (-1 = none)
 
 void setup() {
     Serial.begin(115200);
@@ -40,6 +52,18 @@ void setup() {
     // Load configuration
     bool configLoaded = loadConfig(appConfig);
     
+    // Optional custom screen layout, otherwise the built-in tables
+    if (!layout.loadFromFile(LAYOUT_FILE_PATH)) {
+        Serial.println(F("Using built-in layout"));
+        layout.loadBuiltin();
+    }
+    
+    // Optional custom alert rules, otherwise the built-in table
+    if (!alertEngine.loadFromFile(ALERTS_FILE_PATH)) {
+        Serial.println(F("Using built-in alert rules"));
+        alertEngine.loadBuiltin();
+    }
+    
     if (!configLoaded || strlen(appConfig.wifi.ssid) == 0) {
         Serial.println(F("No valid config, starting AP mode"));
         display.showWiFiSetupMode(DEFAULT_AP_SSID);
@@ -66,8 +90,19 @@ void setup() {
     display.showWiFiConnected(appConfig.wifi.ssid, ipStr);
     delay(WIFI_STATUS_DISPLAY_MS);
     
+    // Sleep between fetch/render deadlines as configured
+    powerManager.begin(static_cast<PowerMode>(DEFAULT_POWER_MODE));
+    
     // Initialize metrics client
     metricsClient.setServerUrl(appConfig.server.url);
+    metricsClient.beginMulticast();
+    
+    // Serve the latest snapshot to other LAN clients
+    mirrorServer.attachPower(&powerManager);
+    mirrorServer.begin();
+    
+    // Firmware updates come from the same server as the metrics
+    otaUpdater.begin(appConfig.server.url);
     
     Serial.println(F("Setup complete, entering main loop"));
 }
@@ -91,7 +126,10 @@ void loop() {
             snprintf(ipStr, sizeof(ipStr), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
             display.showWiFiConnected(appConfig.wifi.ssid, ipStr);
             delay(WIFI_STATUS_DISPLAY_MS);
+            powerManager.begin(powerManager.getMode());
+            metricsClient.beginMulticast();
             alertMode = false;
+            redrawPending = true;
         } else {
             display.showAlert("NO WIFI");
             delay(5000);
@@ -99,57 +137,148 @@ void loop() {
         return;
     }
     
-    // Fetch metrics at configured interval
+    mirrorServer.handleClient();
+    
+    // Checks for new firmware when due, or streams the next slice of an
+    // active download. A verified image reboots the device from here.
+    bool wasUpdating = otaUpdater.isActive();
+    otaUpdater.service();
+    if (otaUpdater.isActive() != wasUpdating) {
+        // Keep the radio fully on while streaming; restore the mode after
+        powerManager.begin(otaUpdater.isActive() ? POWER_ACTIVE : static_cast<PowerMode>(DEFAULT_POWER_MODE));
+        if (!otaUpdater.isActive()) {
+            // Layouts only repaint what changed; wipe the progress bar first
+            display.clear();
+        }
+        otaShownPercent = -1;
+        redrawPending = true;
+    }
+    
+    // Pushed snapshots arrive over multicast; HTTP polling only runs while
+    // no datagrams are arriving, plus one catch-up fetch after a gap
     unsigned long now = millis();
-    if (now - lastMetricsFetch >= appConfig.refresh_ms) {
+    bool newData = false;
+    bool success = false;
+    
+    if (metricsClient.pollMulticast(currentMetrics)) {
+        newData = true;
+        success = true;
+    }
+    
+    bool pollDue = !metricsClient.isMulticastLive() && now - lastMetricsFetch >= appConfig.refresh_ms;
+    
+    if (pollDue || metricsClient.isCatchUpPending()) {
         lastMetricsFetch = now;
+        newData = true;
         
-        bool success = metricsClient.fetchMetrics(currentMetrics);
-        
-        if (!success) {
+        // A failed catch-up keeps any snapshot already applied from multicast
+        if (metricsClient.fetchMetrics(currentMetrics)) {
+            success = true;
+        } else {
             Serial.print(F("Metrics fetch failed. Failures: "));
             Serial.println(metricsClient.getFailureCount());
         }
-        
+    }
+    
+    // Each poll is one alert sample. Multicast sends only changes (heartbeats
+    // repeat them), so while it is live the held snapshot is sampled on the
+    // same refresh_ms cadence instead; a flat bad value still fires.
+    bool multicastLive = metricsClient.isMulticastLive();
+    bool sampled = false;
+    
+    if (newData && success) {
+        mirrorServer.publish(currentMetrics);
+        if (!multicastLive) {
+            alertEngine.evaluate(currentMetrics, WiFi.RSSI());
+            sampled = true;
+        }
+    }
+    if (multicastLive && alertEngine.sampleHeld(currentMetrics, WiFi.RSSI(), now, appConfig.refresh_ms)) {
+        sampled = true;
+    }
+    
+    if (newData || sampled) {
         // Check for alert conditions
-        if (metricsClient.getFailureCount() >= MAX_CONSECUTIVE_FAILURES || currentMetrics.status == 0) {
-            alertMode = true;
-        } else {
-            alertMode = false;
+        if (metricsClient.getFailureCount() >= MAX_CONSECUTIVE_FAILURES) {
+            mirrorServer.invalidate();
+        }
+        
+        bool wasAlert = alertMode;
+        alertMode = metricsClient.getFailureCount() >= MAX_CONSECUTIVE_FAILURES ||
+                    alertEngine.activeRule() != nullptr;
+        if (alertMode != wasAlert) {
+            redrawPending = true;
         }
     }
     
-    // Display logic
+    // Display logic: the panel is only touched when something changed
+    bool drew = false;
     if (alertMode) {
-        if (metricsClient.getFailureCount() >= MAX_CONSECUTIVE_FAILURES) {
-            display.showAlert("NO DATA");
-        } else if (currentMetrics.status == 0) {
-            display.showAlert("BOT DOWN");
+        const AlertRule* rule = alertEngine.activeRule();
+        
+        if (newData || sampled || redrawPending) {
+            if (metricsClient.getFailureCount() >= MAX_CONSECUTIVE_FAILURES) {
+                display.showAlert("NO DATA");
+            } else if (rule != nullptr) {
+                // Name the rule and show what tripped it: the value, or the
+                // change over the rule's window for rate-of-change rules
+                char detail[32];
+                long measured = alertEngine.activeMeasured();
+                if (rule->condition == ALERT_RISE || rule->condition == ALERT_FALL) {
+                    snprintf(detail, sizeof(detail), "%s %+ld / %u", metricFieldName(rule->field),
+                             rule->condition == ALERT_FALL ? -measured : measured, rule->window);
+                } else {
+                    snprintf(detail, sizeof(detail), "%s = %ld", metricFieldName(rule->field), measured);
+                }
+                display.showAlert(rule->name, detail);
+            }
+            redrawPending = false;
+            drew = true;
         }
-        delay(1000);
     } else {
-        // Rotate through screens
+        // Rotate through screens in layout order
         // Note: millis() rollover (~49.7 days) is handled correctly by unsigned arithmetic
-        if (now - lastScreenRotation >= SCREEN_ROTATION_MS) {
+        bool rotated = false;
+        if (now - lastScreenRotation >= layout.screen(currentScreen).durationMs) {
             lastScreenRotation = now;
-            currentScreen = (currentScreen + 1) % 3;
+            currentScreen = (currentScreen + 1) % layout.screenCount();
+            rotated = true;
         }
         
-        int rssi = WiFi.RSSI();
-        
-        switch (currentScreen) {
-            case 0:
-                display.showStatus(currentMetrics, rssi);
-                break;
-            case 1:
-                display.showArb(currentMetrics);
-                break;
-            case 2:
-                display.showPNL(currentMetrics);
-                break;
+        if (newData || rotated || redrawPending) {
+            display.drawLayout(layout, currentScreen, currentMetrics, WiFi.RSSI());
+            redrawPending = false;
+            drew = true;
+        }
+    }
+    
+    if (otaUpdater.isActive()) {
+        uint8_t percent = otaUpdater.progressPercent();
+        if (drew || percent != otaShownPercent) {
+            display.drawProgress(percent);
+            otaShownPercent = percent;
         }
     }
     
-    yield();
-    delay(100);
+    // Sleep until the next fetch or screen rotation, whichever comes first;
+    // idleUntil() returns after POWER_MAX_IDLE_MS at the latest. While
+    // datagrams are arriving or the mirror has recent clients the idle is
+    // cut into POWER_RESPONSIVE_IDLE_MS slices.
+    unsigned long deadline = multicastLive
+        ? now + POWER_RESPONSIVE_IDLE_MS
+        : lastMetricsFetch + appConfig.refresh_ms;
+    unsigned long nextRotation = lastScreenRotation + layout.screen(currentScreen).durationMs;
+    if (!alertMode && (long)(nextRotation - deadline) < 0) {
+        deadline = nextRotation;
+    }
+    if (mirrorServer.hasRecentClients() && (long)(now + POWER_RESPONSIVE_IDLE_MS - deadline) < 0) {
+        deadline = now + POWER_RESPONSIVE_IDLE_MS;
+    }
+    
+    // Don't idle while a download is waiting on the socket
+    if (otaUpdater.isActive()) {
+        deadline = now;
+    }
+    
+    powerManager.idleUntil(deadline);
 }
@@ -0,0 +1,3 @@
+module github.com/tiroq/arb-desk-dashboard/protocol/gen
+
+go 1.21
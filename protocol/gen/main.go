@@ -0,0 +1,361 @@
+// Command gen generates the metrics codecs for the firmware and the test
+// server from protocol/metrics.schema.json, and refreshes the field table in
+// protocol/metrics.md.
+//
+// Usage (from this directory):
+//
+//	go run . -schema ../metrics.schema.json \
+//	    -cpp ../../firmware/src/MetricsSchema.h \
+//	    -go ../../testserver/metrics_gen.go \
+//	    -doc ../metrics.md
+package main
+
+import (
+	"bytes"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"go/format"
+	"log"
+	"os"
+	"sort"
+	"strings"
+)
+
+// Field describes one metric as it appears on the wire
+type Field struct {
+	Key     string `json:"key"`     // JSON key
+	Enum    string `json:"enum"`    // C++ MetricField suffix (FIELD_<Enum>)
+	Cpp     string `json:"cpp"`     // C++ MetricsData member
+	Go      string `json:"go"`      // Go MetricsResponse field
+	Type    string `json:"type"`    // int32 or uint32
+	Since   int    `json:"since"`   // First schema version carrying this field
+	Unit    string `json:"unit"`    // Short comment for generated structs
+	Desc    string `json:"desc"`    // Description for protocol/metrics.md
+	Example int64  `json:"example"` // Example value for protocol/metrics.md
+}
+
+// Schema is the single source of truth for the metrics payload
+type Schema struct {
+	Version int     `json:"version"`
+	Budget  int     `json:"budget"` // Encoded JSON must stay below this many bytes
+	Fields  []Field `json:"fields"`
+}
+
+const (
+	header      = "Code generated by protocol/gen from protocol/metrics.schema.json. DO NOT EDIT."
+	docBegin    = "<!-- BEGIN GENERATED FIELDS -->"
+	docEnd      = "<!-- END GENERATED FIELDS -->"
+	maxFields   = 32 // Firmware datagram buffer holds at most this many fields
+	snapshotHdr = 8  // 'A' 'M' version epoch + sequence
+)
+
+var typeInfo = map[string]struct {
+	cpp      string
+	goType   string
+	maxChars int // Longest decimal rendering
+}{
+	"int32":  {"int", "int", 11},        // -2147483648
+	"uint32": {"uint32_t", "int64", 10}, // 4294967295; Go keeps int64 to hold time.Unix()
+}
+
+func main() {
+	schemaPath := flag.String("schema", "../metrics.schema.json", "Schema file")
+	cppPath := flag.String("cpp", "../../firmware/src/MetricsSchema.h", "Generated C++ header")
+	goPath := flag.String("go", "../../testserver/metrics_gen.go", "Generated Go file")
+	docPath := flag.String("doc", "../metrics.md", "Protocol document with a generated field table")
+	flag.Parse()
+
+	raw, err := os.ReadFile(*schemaPath)
+	if err != nil {
+		log.Fatal(err)
+	}
+
+	var schema Schema
+	if err := json.Unmarshal(raw, &schema); err != nil {
+		log.Fatalf("%s: %v", *schemaPath, err)
+	}
+	if err := validate(&schema); err != nil {
+		log.Fatalf("%s: %v", *schemaPath, err)
+	}
+
+	for v := 1; v <= schema.Version; v++ {
+		log.Printf("schema v%d: %d fields, max JSON %d bytes (budget %d)",
+			v, fieldCount(&schema, v), maxJSONSize(&schema, v), schema.Budget)
+	}
+
+	goSrc, err := format.Source(genGo(&schema))
+	if err != nil {
+		log.Fatalf("generated Go does not parse: %v", err)
+	}
+
+	write(*cppPath, genCpp(&schema))
+	write(*goPath, goSrc)
+
+	if err := updateDoc(*docPath, &schema); err != nil {
+		log.Fatal(err)
+	}
+}
+
+func write(path string, content []byte) {
+	if err := os.WriteFile(path, content, 0644); err != nil {
+		log.Fatal(err)
+	}
+	log.Printf("wrote %s", path)
+}
+
+func validate(s *Schema) error {
+	if s.Version < 1 || s.Version > 255 {
+		return fmt.Errorf("version must be 1..255")
+	}
+	if len(s.Fields) == 0 || len(s.Fields) > maxFields {
+		return fmt.Errorf("need 1..%d fields", maxFields)
+	}
+
+	// Taken by the firmware outside the generated list: FIELD_NONE, FIELD_COUNT
+	// and the device-local "rssi" field (Metrics.h) used by layouts and alerts
+	seen := map[string]bool{"key:rssi": true, "enum:NONE": true, "enum:RSSI": true, "enum:COUNT": true}
+	prevSince := 1
+	for _, f := range s.Fields {
+		if _, ok := typeInfo[f.Type]; !ok {
+			return fmt.Errorf("field %q: unknown type %q", f.Key, f.Type)
+		}
+		for _, name := range []string{"key:" + f.Key, "enum:" + f.Enum, "cpp:" + f.Cpp, "go:" + f.Go} {
+			if strings.HasSuffix(name, ":") {
+				return fmt.Errorf("field %q: key, enum, cpp and go are required", f.Key)
+			}
+			if seen[name] {
+				return fmt.Errorf("duplicate or reserved %s", name)
+			}
+			seen[name] = true
+		}
+		if strings.ContainsAny(f.Key, "\"\\") {
+			return fmt.Errorf("field %q: key must not need escaping", f.Key)
+		}
+		// Fields are append-only, which keeps older snapshots a prefix of newer ones
+		if f.Since < prevSince || f.Since > s.Version {
+			return fmt.Errorf("field %q: since must be non-decreasing and <= version", f.Key)
+		}
+		prevSince = f.Since
+	}
+
+	for v := 1; v <= s.Version; v++ {
+		if size := maxJSONSize(s, v); size >= s.Budget {
+			return fmt.Errorf("schema v%d encodes to up to %d bytes, budget is %d", v, size, s.Budget)
+		}
+	}
+	return nil
+}
+
+func fieldCount(s *Schema, version int) int {
+	n := 0
+	for _, f := range s.Fields {
+		if f.Since <= version {
+			n++
+		}
+	}
+	return n
+}
+
+// maxJSONSize is the worst-case compact encoding including the trailing newline
+func maxJSONSize(s *Schema, version int) int {
+	size := len("{}\n")
+	n := 0
+	for _, f := range s.Fields {
+		if f.Since > version {
+			continue
+		}
+		if n > 0 {
+			size++ // ,
+		}
+		size += len(f.Key) + len(`"":`) + typeInfo[f.Type].maxChars
+		n++
+	}
+	return size
+}
+
+func genCpp(s *Schema) []byte {
+	var b bytes.Buffer
+	n := len(s.Fields)
+
+	fmt.Fprintf(&b, "// %s\n\n", header)
+	b.WriteString("#ifndef METRICS_SCHEMA_H\n#define METRICS_SCHEMA_H\n\n#include <Arduino.h>\n\n")
+
+	fmt.Fprintf(&b, "#define METRICS_SCHEMA_VERSION %d\n", s.Version)
+	fmt.Fprintf(&b, "#define METRICS_FIELD_TOTAL %d\n", n)
+	fmt.Fprintf(&b, "#define METRICS_JSON_MAX_SIZE %d  // Worst case, current version\n\n", maxJSONSize(s, s.Version))
+
+	b.WriteString("struct MetricsData {\n")
+	width := 0
+	for _, f := range s.Fields {
+		if w := len(typeInfo[f.Type].cpp) + len(f.Cpp) + 2; w > width {
+			width = w
+		}
+	}
+	for _, f := range s.Fields {
+		decl := fmt.Sprintf("%s %s;", typeInfo[f.Type].cpp, f.Cpp)
+		fmt.Fprintf(&b, "    %-*s // %s: %s\n", width, decl, f.Key, f.Unit)
+	}
+	b.WriteString("};\n\n")
+
+	b.WriteString("// X(ENUM, member, key, since) in wire order; new fields are only appended\n")
+	b.WriteString("#define METRICS_FIELDS(X) \\\n")
+	for i, f := range s.Fields {
+		sep := " \\"
+		if i == n-1 {
+			sep = ""
+		}
+		fmt.Fprintf(&b, "    X(%s, %s, %q, %d)%s\n", f.Enum, f.Cpp, f.Key, f.Since, sep)
+	}
+	b.WriteString("\n")
+
+	keys := make([]string, n)
+	since := make([]string, n)
+	unsigned := make([]string, n)
+	for i, f := range s.Fields {
+		keys[i] = fmt.Sprintf("%q", f.Key)
+		since[i] = fmt.Sprint(f.Since)
+		unsigned[i] = fmt.Sprint(f.Type == "uint32")
+	}
+	fmt.Fprintf(&b, "static constexpr const char* METRICS_FIELD_KEYS[METRICS_FIELD_TOTAL] = { %s };\n", strings.Join(keys, ", "))
+	fmt.Fprintf(&b, "static constexpr uint8_t METRICS_FIELD_SINCE[METRICS_FIELD_TOTAL] = { %s };\n", strings.Join(since, ", "))
+	fmt.Fprintf(&b, "static constexpr bool METRICS_FIELD_UNSIGNED[METRICS_FIELD_TOTAL] = { %s };\n\n", strings.Join(unsigned, ", "))
+
+	b.WriteString("// Number of fields carried by a given schema version (fields are a prefix)\n")
+	b.WriteString("constexpr uint8_t metricsFieldCount(uint8_t version) {\n")
+	b.WriteString("    uint8_t count = 0;\n")
+	b.WriteString("    for (uint8_t i = 0; i < METRICS_FIELD_TOTAL; i++) {\n")
+	b.WriteString("        if (METRICS_FIELD_SINCE[i] <= version) {\n            count++;\n        }\n    }\n")
+	b.WriteString("    return count;\n}\n\n")
+
+	// Key dispatch: switch on length, then compare bytes directly
+	b.WriteString("// Field index for a JSON key, or -1 for keys this firmware does not know\n")
+	b.WriteString("constexpr int metricsKeyIndex(const char* key, size_t len) {\n")
+	b.WriteString("    switch (len) {\n")
+	byLen := map[int][]int{}
+	for i, f := range s.Fields {
+		byLen[len(f.Key)] = append(byLen[len(f.Key)], i)
+	}
+	lens := make([]int, 0, len(byLen))
+	for l := range byLen {
+		lens = append(lens, l)
+	}
+	sort.Ints(lens)
+	for _, l := range lens {
+		fmt.Fprintf(&b, "        case %d:\n", l)
+		for _, i := range byLen[l] {
+			conds := make([]string, l)
+			for j := 0; j < l; j++ {
+				conds[j] = fmt.Sprintf("key[%d] == '%c'", j, s.Fields[i].Key[j])
+			}
+			fmt.Fprintf(&b, "            if (%s) return %d;\n", strings.Join(conds, " && "), i)
+		}
+		b.WriteString("            break;\n")
+	}
+	b.WriteString("    }\n    return -1;\n}\n\n")
+	for i, f := range s.Fields {
+		fmt.Fprintf(&b, "static_assert(metricsKeyIndex(%q, %d) == %d, \"key dispatch\");\n", f.Key, len(f.Key), i)
+	}
+	b.WriteString("\n")
+
+	b.WriteString("inline int32_t metricsGetField(const MetricsData &data, uint8_t index) {\n    switch (index) {\n")
+	for i, f := range s.Fields {
+		fmt.Fprintf(&b, "        case %d: return (int32_t)data.%s;\n", i, f.Cpp)
+	}
+	b.WriteString("        default: return 0;\n    }\n}\n\n")
+
+	b.WriteString("inline void metricsSetField(MetricsData &data, uint8_t index, int64_t value) {\n    switch (index) {\n")
+	for i, f := range s.Fields {
+		fmt.Fprintf(&b, "        case %d: data.%s = (%s)value; break;\n", i, f.Cpp, typeInfo[f.Type].cpp)
+	}
+	b.WriteString("        default: break;\n    }\n}\n\n")
+
+	b.WriteString("#endif // METRICS_SCHEMA_H\n")
+	return b.Bytes()
+}
+
+func genGo(s *Schema) []byte {
+	var b bytes.Buffer
+
+	fmt.Fprintf(&b, "// %s\n\npackage main\n\n", header)
+	b.WriteString("import (\n\t\"encoding/binary\"\n\t\"strconv\"\n)\n\n")
+
+	fmt.Fprintf(&b, "// metricsSchemaVersion is the newest schema version this server can encode\n")
+	fmt.Fprintf(&b, "const metricsSchemaVersion = %d\n\n", s.Version)
+	fmt.Fprintf(&b, "// metricsSnapshotSize is the binary snapshot size at metricsSchemaVersion\n")
+	fmt.Fprintf(&b, "const metricsSnapshotSize = %d\n\n", snapshotHdr+4*len(s.Fields))
+
+	b.WriteString("// MetricsResponse represents the API response structure\ntype MetricsResponse struct {\n")
+	for _, f := range s.Fields {
+		fmt.Fprintf(&b, "\t%s %s `json:\"%s\"` // %s\n", f.Go, typeInfo[f.Type].goType, f.Key, f.Unit)
+	}
+	b.WriteString("}\n\n")
+
+	b.WriteString("// appendMetricsJSON appends the compact JSON encoding of m, limited to the\n")
+	b.WriteString("// fields known to schema version v\n")
+	b.WriteString("func appendMetricsJSON(b []byte, m *MetricsResponse, v int) []byte {\n")
+	for i, f := range s.Fields {
+		prefix := ","
+		if i == 0 {
+			prefix = "{"
+		}
+		indent := "\t"
+		if f.Since > 1 {
+			fmt.Fprintf(&b, "\tif v >= %d {\n", f.Since)
+			indent = "\t\t"
+		}
+		fmt.Fprintf(&b, "%sb = append(b, `%s\"%s\":`...)\n", indent, prefix, f.Key)
+		fmt.Fprintf(&b, "%sb = strconv.AppendInt(b, int64(m.%s), 10)\n", indent, f.Go)
+		if f.Since > 1 {
+			b.WriteString("\t}\n")
+		}
+	}
+	b.WriteString("\treturn append(b, '}')\n}\n\n")
+
+	b.WriteString("// appendMetricsSnapshot appends the little-endian binary snapshot of m;\n")
+	b.WriteString("// epoch identifies the sender's current run (0 = none)\n")
+	b.WriteString("func appendMetricsSnapshot(b []byte, epoch uint8, seq uint32, m *MetricsResponse) []byte {\n")
+	b.WriteString("\tb = append(b, 'A', 'M', metricsSchemaVersion, epoch)\n")
+	b.WriteString("\tb = binary.LittleEndian.AppendUint32(b, seq)\n")
+	for _, f := range s.Fields {
+		conv := "uint32(int32(m." + f.Go + "))"
+		if f.Type == "uint32" {
+			conv = "uint32(m." + f.Go + ")"
+		}
+		fmt.Fprintf(&b, "\tb = binary.LittleEndian.AppendUint32(b, %s)\n", conv)
+	}
+	b.WriteString("\treturn b\n}\n")
+
+	return b.Bytes()
+}
+
+func updateDoc(path string, s *Schema) error {
+	doc, err := os.ReadFile(path)
+	if err != nil {
+		return err
+	}
+
+	start := bytes.Index(doc, []byte(docBegin))
+	end := bytes.Index(doc, []byte(docEnd))
+	if start < 0 || end < start {
+		return fmt.Errorf("%s: missing %s / %s markers", path, docBegin, docEnd)
+	}
+
+	var t bytes.Buffer
+	t.WriteString(docBegin + "\n")
+	t.WriteString("| Field | Type | Description | Example | Since |\n")
+	t.WriteString("|-------|------|-------------|---------|-------|\n")
+	for _, f := range s.Fields {
+		fmt.Fprintf(&t, "| `%s` | int | %s | %d | v%d |\n", f.Key, f.Desc, f.Example, f.Since)
+	}
+	fmt.Fprintf(&t, "\nSchema version %d; worst-case encoded size %d bytes.\n",
+		s.Version, maxJSONSize(s, s.Version))
+
+	var out bytes.Buffer
+	out.Write(doc[:start])
+	out.Write(t.Bytes())
+	out.Write(doc[end:])
+
+	write(path, out.Bytes())
+	return nil
+}
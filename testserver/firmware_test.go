@@ -0,0 +1,145 @@
+package main
+
+import (
+	"bufio"
+	"fmt"
+	"os/exec"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+// Host checks of the portable firmware units. testdata/firmware holds
+// stand-ins for the Arduino headers and a small driver; the units themselves
+// are built straight from firmware/src with the system C++ compiler.
+
+// hostCheck builds the driver into the test's temp dir and returns its path
+func hostCheck(t *testing.T) string {
+	t.Helper()
+	cxx, err := exec.LookPath("c++")
+	if err != nil {
+		t.Skip("no C++ compiler on PATH")
+	}
+
+	dir, err := filepath.Abs("testdata/firmware")
+	if err != nil {
+		t.Fatal(err)
+	}
+	src := filepath.Join(dir, "..", "..", "..", "firmware", "src")
+	path := filepath.Join(t.TempDir(), "host_check")
+
+	cmd := exec.Command(cxx, "-std=c++17", "-Wall", "-Wextra", "-Werror",
+		"-I"+dir, "-I"+src, "-o", path,
+		filepath.Join(dir, "host_check.cpp"),
+		filepath.Join(src, "AlertRules.cpp"),
+		filepath.Join(src, "Metrics.cpp"),
+		filepath.Join(src, "Crc32.cpp"))
+	if out, err := cmd.CombinedOutput(); err != nil {
+		t.Fatalf("%v\n%s", err, out)
+	}
+	return path
+}
+
+// runHostCheck feeds commands to the driver and returns one result per command
+func runHostCheck(t *testing.T, commands []string) []string {
+	t.Helper()
+	cmd := exec.Command(hostCheck(t))
+	cmd.Stdin = strings.NewReader(strings.Join(commands, "\n") + "\n")
+	out, err := cmd.Output()
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	var results []string
+	scanner := bufio.NewScanner(strings.NewReader(string(out)))
+	for scanner.Scan() {
+		results = append(results, scanner.Text())
+	}
+	if len(results) != len(commands) {
+		t.Fatalf("%d results for %d commands", len(results), len(commands))
+	}
+	return results
+}
+
+func TestFirmwareParsesMetricsJSON(t *testing.T) {
+	// What the server sends must come back unchanged, extremes included
+	edge := MetricsResponse{Status: 1, Latency: 2147483647, BestArb: -2147483648, PNL: -482, Timestamp: 4294967295}
+	encoded := string(appendMetricsJSON(nil, &edge, metricsSchemaVersion))
+
+	cases := []struct{ in, want string }{
+		{encoded, "ok " + encoded},
+		{`{"s":1,"l":42}`, `ok {"s":1,"l":42,"a":0,"b":0,"p":0,"e":0,"ts":0}`},
+		{` { "s" : 1 , "x" : [1, {"y": "}"}] , "l" : null } ` + "	", `ok {"s":1,"l":0,"a":0,"b":0,"p":0,"e":0,"ts":0}`},
+		{`{"s":-0,"x":"1"}`, `ok {"s":0,"l":0,"a":0,"b":0,"p":0,"e":0,"ts":0}`},
+		{`{}`, `ok {"s":0,"l":0,"a":0,"b":0,"p":0,"e":0,"ts":0}`},
+
+		// Out of the field's 32-bit range
+		{`{"l":99999999999999}`, "reject"},
+		{`{"l":2147483648}`, "reject"},
+		{`{"l":-2147483649}`, "reject"},
+		{`{"ts":4294967296}`, "reject"},
+		{`{"ts":-1}`, "reject"},
+
+		// Not a plain integer
+		{`{"l":-}`, "reject"},
+		{`{"l":-x,"s":1}`, "reject"},
+		{`{"s":"1"}`, "reject"},
+		{`{"s":1e3}`, "reject"},
+		{`{"s":1.5}`, "reject"},
+		{`{"s":01}`, "reject"},
+		{`{"s":true}`, "reject"},
+		{`{"s":nullx}`, "reject"},
+
+		// Structure
+		{`{"s":}`, "reject"},
+		{`{"x":,"s":1}`, "reject"},
+		{`{"s":1}garbage`, "reject"},
+		{`{"s":1`, "reject"},
+		{`[1]`, "reject"},
+	}
+
+	commands := make([]string, len(cases))
+	for i, c := range cases {
+		commands[i] = "parse " + c.in
+	}
+	for i, got := range runHostCheck(t, commands) {
+		if got != cases[i].want {
+			t.Errorf("%s: got %s, want %s", cases[i].in, got, cases[i].want)
+		}
+	}
+}
+
+// While multicast is live only changes are pushed, so a constant value
+// arrives once. The firmware's loop calls sampleHeld every 250 ms; rules
+// must still see one sample per refresh interval.
+func TestHeldSnapshotFeedsAlertsPerInterval(t *testing.T) {
+	const interval, step, latency = 3000, 250, 900
+
+	var commands []string
+	for now := 0; now <= 9000; now += step {
+		commands = append(commands, fmt.Sprintf("held %d %d %d", now, interval, latency))
+	}
+	results := runHostCheck(t, commands)
+
+	samples := 0
+	for i, result := range results {
+		now := i * step
+		sampled, rule, _ := strings.Cut(result, " ")
+
+		if want := now%interval == 0; (sampled == "1") != want {
+			t.Errorf("t=%d: sampled=%s, want %v", now, sampled, want)
+		}
+		if sampled == "1" {
+			samples++
+		}
+
+		// HIGH LATENCY needs 3 consecutive samples above 500 ms
+		want := "-"
+		if samples >= 3 {
+			want = "HIGH LATENCY"
+		}
+		if rule != want {
+			t.Errorf("t=%d after %d samples: active %q, want %q", now, samples, rule, want)
+		}
+	}
+}
@@ -1,33 +1,42 @@
 package main
 
 import (
+	"encoding/binary"
 	"encoding/json"
 	"flag"
 	"fmt"
+	"hash/crc32"
 	"log"
 	"math/rand"
+	"net"
 	"net/http"
+	"strconv"
 	"sync"
 	"time"
 )
 
-// MetricsResponse represents the API response structure
-type MetricsResponse struct {
-	Status          int   `json:"s"`  // 1=ok, 0=down
-	Latency         int   `json:"l"`  // ms
-	ActiveTriangles int   `json:"a"`  // count
-	BestArb         int   `json:"b"`  // percentage × 100
-	PNL             int   `json:"p"`  // cents
-	Errors          int   `json:"e"`  // count
-	Timestamp       int64 `json:"ts"` // epoch seconds
-}
+// HTTP headers (see protocol/metrics.md)
+const (
+	sequenceHeader = "X-Metrics-Seq"
+	schemaHeader   = "X-Metrics-Schema"
+)
 
 var (
 	port      = flag.Int("port", 8080, "Server port")
 	mode      = flag.String("mode", "ok", "Server mode: ok, down, or flap")
 	latencyMs = flag.Int("latency-ms", 35, "Base latency in milliseconds")
+	multicast = flag.String("multicast", "", "Multicast group:port to push snapshots to (e.g. 239.77.66.1:5007), empty disables")
+	interval  = flag.Duration("multicast-interval", time.Second, "How often a new snapshot is generated in multicast mode")
+	heartbeat = flag.Duration("multicast-heartbeat", 2*time.Second, "How often the latest snapshot is re-sent")
 	rng       = rand.New(rand.NewSource(time.Now().UnixNano()))
 	rngMutex  sync.Mutex // Protect concurrent access to rng
+
+	// Latest snapshot in multicast mode; HTTP serves the same one so
+	// catch-up fetches agree with what was pushed
+	snapshotMutex sync.Mutex
+	snapshotEpoch uint8 // Random per start, so dashboards see a restart
+	snapshotSeq   uint32
+	snapshot      MetricsResponse
 )
 
 func main() {
@@ -36,6 +45,18 @@ func main() {
 	http.HandleFunc("/", handleRoot)
 	http.HandleFunc("/api/v1/metrics", handleMetrics)
 
+	if *multicast != "" {
+		if err := startMulticast(*multicast); err != nil {
+			log.Fatal(err)
+		}
+	}
+
+	if *otaDir != "" {
+		if err := startOTA(); err != nil {
+			log.Fatal(err)
+		}
+	}
+
 	addr := fmt.Sprintf(":%d", *port)
 	log.Printf("Starting ARB test server on %s", addr)
 	log.Printf("Mode: %s, Base Latency: %dms", *mode, *latencyMs)
@@ -71,7 +92,7 @@ func handleRoot(w http.ResponseWriter, r *http.Request) {
             <strong>Port:</strong> ` + fmt.Sprintf("%d", *port) + `
         </div>
         <h2>API Endpoint</h2>
-        <p><a href="/api/v1/metrics">/api/v1/metrics</a></p>
+        <p><a href="/api/v1/metrics">/api/v1/metrics</a></p>` + otaLinks() + `
         <h2>Sample Response</h2>
         <div class="metrics">
             <pre>` + getSampleJSON() + `</pre>
@@ -93,10 +114,31 @@ func safeIntn(n int) int {
 func handleMetrics(w http.ResponseWriter, r *http.Request) {
 	var resp MetricsResponse
 
+	// Clients name the newest schema they understand; old firmware sends none
+	version := 1
+	if v, err := strconv.Atoi(r.Header.Get(schemaHeader)); err == nil && v > 1 {
+		version = min(v, metricsSchemaVersion)
+	}
+
+	if *multicast != "" {
+		snapshotMutex.Lock()
+		resp = snapshot
+		w.Header().Set(sequenceHeader, strconv.FormatUint(uint64(snapshotSeq), 10))
+		snapshotMutex.Unlock()
+	} else {
+		resp = generateMetrics()
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	w.Header().Set(schemaHeader, strconv.Itoa(version))
+	w.Write(append(appendMetricsJSON(nil, &resp, version), '\n'))
+}
+
+func generateMetrics() MetricsResponse {
 	switch *mode {
 	case "down":
 		// Bot is down
-		resp = MetricsResponse{
+		return MetricsResponse{
 			Status:          0,
 			Latency:         0,
 			ActiveTriangles: 0,
@@ -109,25 +151,100 @@ func handleMetrics(w http.ResponseWriter, r *http.Request) {
 	case "flap":
 		// Randomly flap between ok and down
 		if safeIntn(2) == 0 {
-			resp = generateOkMetrics()
-		} else {
-			resp = MetricsResponse{
-				Status:          0,
-				Latency:         0,
-				ActiveTriangles: 0,
-				BestArb:         0,
-				PNL:             safeIntn(2000) - 500,
-				Errors:          safeIntn(15),
-				Timestamp:       time.Now().Unix(),
-			}
+			return generateOkMetrics()
+		}
+		return MetricsResponse{
+			Status:          0,
+			Latency:         0,
+			ActiveTriangles: 0,
+			BestArb:         0,
+			PNL:             safeIntn(2000) - 500,
+			Errors:          safeIntn(15),
+			Timestamp:       time.Now().Unix(),
 		}
 
 	default: // "ok"
-		resp = generateOkMetrics()
+		return generateOkMetrics()
 	}
+}
 
-	w.Header().Set("Content-Type", "application/json")
-	json.NewEncoder(w).Encode(resp)
+// startMulticast generates a snapshot every interval and pushes it to the
+// group once if anything other than the timestamp changed. The latest
+// datagram is re-sent every heartbeat so listeners can tell the feed is alive.
+func startMulticast(groupAddr string) error {
+	addr, err := net.ResolveUDPAddr("udp4", groupAddr)
+	if err != nil {
+		return fmt.Errorf("invalid multicast address %q: %w", groupAddr, err)
+	}
+	if !addr.IP.IsMulticast() {
+		return fmt.Errorf("%s is not a multicast address", addr.IP)
+	}
+
+	conn, err := net.DialUDP("udp4", nil, addr)
+	if err != nil {
+		return err
+	}
+
+	snapshotMutex.Lock()
+	snapshotEpoch = uint8(1 + safeIntn(255))
+	snapshotSeq = 1
+	snapshot = generateMetrics()
+	datagram := encodeDatagram(snapshotSeq, snapshot)
+	snapshotMutex.Unlock()
+
+	log.Printf("Multicast: pushing to %s (interval %s, heartbeat %s)", addr, *interval, *heartbeat)
+
+	go func() {
+		generate := time.NewTicker(*interval)
+		resend := time.NewTicker(*heartbeat)
+		defer generate.Stop()
+		defer resend.Stop()
+
+		send := func(b []byte) {
+			if _, err := conn.Write(b); err != nil {
+				log.Printf("Multicast send failed: %v", err)
+			}
+		}
+		send(datagram)
+
+		for {
+			select {
+			case <-generate.C:
+				next := generateMetrics()
+
+				snapshotMutex.Lock()
+				changed := !sameMetrics(next, snapshot)
+				if changed {
+					snapshotSeq++
+					snapshot = next
+					datagram = encodeDatagram(snapshotSeq, snapshot)
+				}
+				snapshotMutex.Unlock()
+
+				if changed {
+					send(datagram)
+					resend.Reset(*heartbeat)
+				}
+
+			case <-resend.C:
+				send(datagram)
+			}
+		}
+	}()
+
+	return nil
+}
+
+// sameMetrics compares snapshots ignoring the timestamp
+func sameMetrics(a, b MetricsResponse) bool {
+	a.Timestamp = b.Timestamp
+	return a == b
+}
+
+// encodeDatagram builds the binary snapshot followed by its CRC32
+func encodeDatagram(seq uint32, m MetricsResponse) []byte {
+	b := appendMetricsSnapshot(make([]byte, 0, metricsSnapshotSize+4), snapshotEpoch, seq, &m)
+	return binary.LittleEndian.AppendUint32(b, crc32.ChecksumIEEE(b))
 }
 
 func generateOkMetrics() MetricsResponse {
@@ -0,0 +1,60 @@
+// Code generated by protocol/gen from protocol/metrics.schema.json. DO NOT EDIT.
+
+package main
+
+import (
+	"encoding/binary"
+	"strconv"
+)
+
+// metricsSchemaVersion is the newest schema version this server can encode
+const metricsSchemaVersion = 1
+
+// metricsSnapshotSize is the binary snapshot size at metricsSchemaVersion
+const metricsSnapshotSize = 36
+
+// MetricsResponse represents the API response structure
+type MetricsResponse struct {
+	Status          int   `json:"s"`  // 1=ok, 0=down
+	Latency         int   `json:"l"`  // ms
+	ActiveTriangles int   `json:"a"`  // count
+	BestArb         int   `json:"b"`  // percentage × 100
+	PNL             int   `json:"p"`  // cents
+	Errors          int   `json:"e"`  // count
+	Timestamp       int64 `json:"ts"` // epoch seconds (uint32_t for consistency, valid until year 2106)
+}
+
+// appendMetricsJSON appends the compact JSON encoding of m, limited to the
+// fields known to schema version v
+func appendMetricsJSON(b []byte, m *MetricsResponse, v int) []byte {
+	b = append(b, `{"s":`...)
+	b = strconv.AppendInt(b, int64(m.Status), 10)
+	b = append(b, `,"l":`...)
+	b = strconv.AppendInt(b, int64(m.Latency), 10)
+	b = append(b, `,"a":`...)
+	b = strconv.AppendInt(b, int64(m.ActiveTriangles), 10)
+	b = append(b, `,"b":`...)
+	b = strconv.AppendInt(b, int64(m.BestArb), 10)
+	b = append(b, `,"p":`...)
+	b = strconv.AppendInt(b, int64(m.PNL), 10)
+	b = append(b, `,"e":`...)
+	b = strconv.AppendInt(b, int64(m.Errors), 10)
+	b = append(b, `,"ts":`...)
+	b = strconv.AppendInt(b, int64(m.Timestamp), 10)
+	return append(b, '}')
+}
+
+// appendMetricsSnapshot appends the little-endian binary snapshot of m;
+// epoch identifies the sender's current run (0 = none)
+func appendMetricsSnapshot(b []byte, epoch uint8, seq uint32, m *MetricsResponse) []byte {
+	b = append(b, 'A', 'M', metricsSchemaVersion, epoch)
+	b = binary.LittleEndian.AppendUint32(b, seq)
+	b = binary.LittleEndian.AppendUint32(b, uint32(int32(m.Status)))
+	b = binary.LittleEndian.AppendUint32(b, uint32(int32(m.Latency)))
+	b = binary.LittleEndian.AppendUint32(b, uint32(int32(m.ActiveTriangles)))
+	b = binary.LittleEndian.AppendUint32(b, uint32(int32(m.BestArb)))
+	b = binary.LittleEndian.AppendUint32(b, uint32(int32(m.PNL)))
+	b = binary.LittleEndian.AppendUint32(b, uint32(int32(m.Errors)))
+	b = binary.LittleEndian.AppendUint32(b, uint32(m.Timestamp))
+	return b
+}
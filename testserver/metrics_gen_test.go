@@ -0,0 +1,139 @@
+package main
+
+import (
+	"bufio"
+	"encoding/binary"
+	"encoding/json"
+	"os"
+	"regexp"
+	"strconv"
+	"testing"
+)
+
+// Checks the generated encoders against the layout documented in
+// protocol/metrics.md, so a generator change that drifts from the spec fails
+// here before any firmware is flashed.
+
+const metricsDoc = "../protocol/metrics.md"
+
+var sample = MetricsResponse{
+	Status:          1,
+	Latency:         42,
+	ActiveTriangles: 3,
+	BestArb:         -18,
+	PNL:             -482,
+	Errors:          7,
+	Timestamp:       0xF0000000, // Above int32, must stay unsigned on the wire
+}
+
+// sampleValues maps each wire key to the value it carries in sample
+func sampleValues() map[string]int64 {
+	return map[string]int64{
+		"s":  int64(sample.Status),
+		"l":  int64(sample.Latency),
+		"a":  int64(sample.ActiveTriangles),
+		"b":  int64(sample.BestArb),
+		"p":  int64(sample.PNL),
+		"e":  int64(sample.Errors),
+		"ts": sample.Timestamp,
+	}
+}
+
+// docRows returns the capture groups of every line in metrics.md matching re
+func docRows(t *testing.T, re *regexp.Regexp) [][]string {
+	t.Helper()
+	f, err := os.Open(metricsDoc)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+
+	var rows [][]string
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		if m := re.FindStringSubmatch(scanner.Text()); m != nil {
+			rows = append(rows, m)
+		}
+	}
+	if err := scanner.Err(); err != nil {
+		t.Fatal(err)
+	}
+	return rows
+}
+
+func TestMetricsJSONMatchesDoc(t *testing.T) {
+	// Field Definitions table: | `key` | type | description | example | vN |
+	rows := docRows(t, regexp.MustCompile("^\\| `([a-z]+)` \\| int \\|.*\\| v(\\d+) \\|$"))
+	if len(rows) == 0 {
+		t.Fatal("no field rows found in " + metricsDoc)
+	}
+
+	encoded := appendMetricsJSON(nil, &sample, metricsSchemaVersion)
+
+	var fields map[string]int64
+	if err := json.Unmarshal(encoded, &fields); err != nil {
+		t.Fatalf("%s: %v", encoded, err)
+	}
+	want := sampleValues()
+	for _, row := range rows {
+		key := row[1]
+		got, ok := fields[key]
+		if !ok {
+			t.Errorf("documented key %q missing from %s", key, encoded)
+			continue
+		}
+		if got != want[key] {
+			t.Errorf("%q = %d, want %d", key, got, want[key])
+		}
+		delete(fields, key)
+	}
+	for key := range fields {
+		t.Errorf("key %q is encoded but not documented", key)
+	}
+
+	var decoded MetricsResponse
+	if err := json.Unmarshal(encoded, &decoded); err != nil {
+		t.Fatal(err)
+	}
+	if decoded != sample {
+		t.Errorf("round trip = %+v, want %+v", decoded, sample)
+	}
+}
+
+func TestMetricsSnapshotMatchesDoc(t *testing.T) {
+	const epoch, seq = 0xA5, 0x01020304
+	snap := appendMetricsSnapshot(nil, epoch, seq, &sample)
+
+	if len(snap) != metricsSnapshotSize {
+		t.Fatalf("snapshot is %d bytes, want %d", len(snap), metricsSnapshotSize)
+	}
+	if snap[0] != 'A' || snap[1] != 'M' || snap[2] != metricsSchemaVersion || snap[3] != epoch {
+		t.Errorf("header = % x", snap[:4])
+	}
+	if got := binary.LittleEndian.Uint32(snap[4:]); got != seq {
+		t.Errorf("sequence = %#x, want %#x", got, seq)
+	}
+
+	// Binary Snapshot table: | offset | 4 | `key` (int32|uint32) |
+	rows := docRows(t, regexp.MustCompile("^\\| (\\d+) \\| 4 \\| `([a-z]+)` \\((int32|uint32)\\) \\|$"))
+	want := sampleValues()
+	if len(rows) != len(want) {
+		t.Fatalf("%d documented snapshot fields, encoder has %d", len(rows), len(want))
+	}
+	for _, row := range rows {
+		offset, _ := strconv.Atoi(row[1])
+		key, kind := row[2], row[3]
+		if offset+4 > len(snap) {
+			t.Errorf("%q at offset %d is past the %d-byte snapshot", key, offset, len(snap))
+			continue
+		}
+		word := binary.LittleEndian.Uint32(snap[offset:])
+		got := int64(int32(word))
+		if kind == "uint32" {
+			got = int64(word)
+		}
+		if got != want[key] {
+			t.Errorf("%q at offset %d = %d, want %d", key, offset, got, want[key])
+		}
+	}
+}
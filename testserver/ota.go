@@ -0,0 +1,259 @@
+package main
+
+import (
+	"encoding/json"
+	"flag"
+	"hash/crc32"
+	"io"
+	"log"
+	"net"
+	"net/http"
+	"os"
+	"path"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"sync"
+	"time"
+)
+
+// OTA image hosting (see protocol/ota.md): serves manifest.json and images
+// from --ota-dir and tracks every device's download so a staged rollout can
+// be watched at /ota/status.
+
+var (
+	otaDir  = flag.String("ota-dir", "", "Directory with manifest.json and firmware images to serve under /ota/, empty disables")
+	otaRate = flag.Int("ota-rate-kbps", 0, "Limit each image download to this many KB/s (0 = unlimited)")
+
+	otaMutex   sync.Mutex
+	otaDevices = map[string]*otaDevice{}
+)
+
+const (
+	deviceIDHeader = "X-Device-Id"
+	buildHeader    = "X-Firmware-Build"
+	otaChunkSize   = 1024
+)
+
+// otaDevice is one dashboard's last known update state
+type otaDevice struct {
+	ID       string    `json:"id"`
+	Bucket   uint32    `json:"bucket"` // Rollout bucket, same hash as the firmware
+	Build    int       `json:"build"`  // Build the device reported running
+	State    string    `json:"state"`  // checked-in, downloading, sent, updated, failed
+	Image    string    `json:"image,omitempty"`
+	Bytes    int64     `json:"bytes"`
+	Total    int64     `json:"total"`
+	Percent  int       `json:"percent"`
+	KBps     float64   `json:"kbps"`
+	Error    string    `json:"error,omitempty"`
+	LastSeen time.Time `json:"last_seen"`
+
+	started time.Time
+}
+
+// otaReport is posted by a device when a download ends
+type otaReport struct {
+	Target int    `json:"target"`
+	OK     bool   `json:"ok"`
+	Bytes  int64  `json:"bytes"`
+	Ms     int64  `json:"ms"`
+	Error  string `json:"error"`
+}
+
+func startOTA() error {
+	if _, err := os.Stat(filepath.Join(*otaDir, "manifest.json")); err != nil {
+		return err
+	}
+
+	http.HandleFunc("/ota/manifest.json", handleOTAManifest)
+	http.HandleFunc("/ota/report", handleOTAReport)
+	http.HandleFunc("/ota/status", handleOTAStatus)
+	http.HandleFunc("/ota/", handleOTAImage)
+
+	log.Printf("OTA: serving %s (rate limit %d KB/s, 0 = none)", *otaDir, *otaRate)
+	return nil
+}
+
+// otaLinks is the OTA section of the index page, empty when OTA is disabled
+func otaLinks() string {
+	if *otaDir == "" {
+		return ""
+	}
+	return `
+        <h2>Firmware Updates</h2>
+        <p><a href="/ota/manifest.json">/ota/manifest.json</a> &middot; <a href="/ota/status">/ota/status</a></p>`
+}
+
+// otaTouch records a request from a device and returns its entry.
+// Callers must hold otaMutex.
+func otaTouch(r *http.Request) *otaDevice {
+	id := r.Header.Get(deviceIDHeader)
+	if id == "" {
+		// Not a dashboard (e.g. curl); key it by address instead
+		id, _, _ = net.SplitHostPort(r.RemoteAddr)
+	}
+
+	dev, ok := otaDevices[id]
+	if !ok {
+		dev = &otaDevice{ID: id, Bucket: crc32.ChecksumIEEE([]byte(id)) % 100, State: "checked-in"}
+		otaDevices[id] = dev
+	}
+	if build, err := strconv.Atoi(r.Header.Get(buildHeader)); err == nil {
+		dev.Build = build
+	}
+	dev.LastSeen = time.Now()
+	return dev
+}
+
+func handleOTAManifest(w http.ResponseWriter, r *http.Request) {
+	otaMutex.Lock()
+	otaTouch(r)
+	otaMutex.Unlock()
+
+	// Re-read on every request so the rollout can be edited live
+	w.Header().Set("Cache-Control", "no-store")
+	http.ServeFile(w, r, filepath.Join(*otaDir, "manifest.json"))
+}
+
+func handleOTAImage(w http.ResponseWriter, r *http.Request) {
+	name := path.Base(r.URL.Path)
+	f, err := os.Open(filepath.Join(*otaDir, name))
+	if err != nil {
+		http.NotFound(w, r)
+		return
+	}
+	defer f.Close()
+
+	info, err := f.Stat()
+	if err != nil || info.IsDir() {
+		http.NotFound(w, r)
+		return
+	}
+
+	otaMutex.Lock()
+	dev := otaTouch(r)
+	dev.State, dev.Image, dev.Error = "downloading", name, ""
+	dev.Bytes, dev.Total, dev.Percent, dev.KBps = 0, info.Size(), 0, 0
+	dev.started = time.Now()
+	id, started := dev.ID, dev.started
+	otaMutex.Unlock()
+
+	log.Printf("OTA %s: sending %s (%d bytes)", id, name, info.Size())
+
+	// The device sizes the update partition from Content-Length
+	w.Header().Set("Content-Type", "application/octet-stream")
+	w.Header().Set("Content-Length", strconv.FormatInt(info.Size(), 10))
+
+	buf := make([]byte, otaChunkSize)
+	var sent int64
+	lastStep := 0
+
+	for {
+		n, readErr := f.Read(buf)
+		if n > 0 {
+			// Write blocks once the device's TCP window is full, so this
+			// tracks how fast it drains the stream into flash
+			if _, err := w.Write(buf[:n]); err != nil {
+				otaFinish(id, "failed", err.Error())
+				log.Printf("OTA %s: aborted at %d bytes: %v", id, sent, err)
+				return
+			}
+			sent += int64(n)
+
+			elapsed := time.Since(started)
+			if *otaRate > 0 {
+				due := time.Duration(sent * int64(time.Second) / int64(*otaRate*1024))
+				if due > elapsed {
+					time.Sleep(due - elapsed)
+					elapsed = due
+				}
+			}
+
+			percent := int(sent * 100 / info.Size())
+			kbps := 0.0
+			if elapsed > 0 {
+				kbps = float64(sent) / 1024 / elapsed.Seconds()
+			}
+
+			otaMutex.Lock()
+			dev.Bytes, dev.Percent, dev.KBps = sent, percent, kbps
+			otaMutex.Unlock()
+
+			if step := percent / 10; step > lastStep {
+				lastStep = step
+				log.Printf("OTA %s: %d%% (%d KB, %.1f KB/s)", id, percent, sent/1024, kbps)
+			}
+		}
+		if readErr == io.EOF {
+			break
+		}
+		if readErr != nil {
+			otaFinish(id, "failed", readErr.Error())
+			return
+		}
+	}
+
+	// Flashing and verification finish on the device, which reports back
+	otaFinish(id, "sent", "")
+}
+
+func otaFinish(id, state, errMsg string) {
+	otaMutex.Lock()
+	defer otaMutex.Unlock()
+	if dev, ok := otaDevices[id]; ok {
+		dev.State, dev.Error = state, errMsg
+	}
+}
+
+func handleOTAReport(w http.ResponseWriter, r *http.Request) {
+	if r.Method != http.MethodPost {
+		http.Error(w, "POST only", http.StatusMethodNotAllowed)
+		return
+	}
+
+	var report otaReport
+	if err := json.NewDecoder(io.LimitReader(r.Body, 1024)).Decode(&report); err != nil {
+		http.Error(w, err.Error(), http.StatusBadRequest)
+		return
+	}
+
+	otaMutex.Lock()
+	dev := otaTouch(r)
+	if report.OK {
+		dev.State, dev.Error = "updated", ""
+	} else {
+		dev.State, dev.Error = "failed", report.Error
+	}
+	dev.Bytes = report.Bytes
+	if report.Ms > 0 {
+		// The device's own measurement includes flash writes
+		dev.KBps = float64(report.Bytes) / 1024 / (float64(report.Ms) / 1000)
+	}
+	id, kbps := dev.ID, dev.KBps
+	otaMutex.Unlock()
+
+	if report.OK {
+		log.Printf("OTA %s: build %d flashed and verified (%d bytes in %d ms, %.1f KB/s)",
+			id, report.Target, report.Bytes, report.Ms, kbps)
+	} else {
+		log.Printf("OTA %s: build %d failed after %d bytes: %s", id, report.Target, report.Bytes, report.Error)
+	}
+	w.WriteHeader(http.StatusNoContent)
+}
+
+func handleOTAStatus(w http.ResponseWriter, r *http.Request) {
+	otaMutex.Lock()
+	devices := make([]otaDevice, 0, len(otaDevices))
+	for _, dev := range otaDevices {
+		devices = append(devices, *dev)
+	}
+	otaMutex.Unlock()
+
+	sort.Slice(devices, func(i, j int) bool { return devices[i].ID < devices[j].ID })
+
+	w.Header().Set("Content-Type", "application/json")
+	enc := json.NewEncoder(w)
+	enc.SetIndent("", "  ")
+	enc.Encode(devices)
+}
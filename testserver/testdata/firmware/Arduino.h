@@ -0,0 +1,24 @@
+// Host stand-in for the parts of the Arduino core that the portable firmware
+// units (Metrics, Crc32, AlertRules) use, so firmware_test.go can build them
+// with the system C++ compiler. Output goes nowhere.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+
+struct HostSerial {
+    template <typename T> void print(const T &) {}
+    template <typename T> void println(const T &) {}
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,47 @@
+// Host stand-in: just enough of the ArduinoJson 6 API for
+// AlertEngine::loadFromFile to compile. Every lookup is empty.
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include <Arduino.h>
+
+struct JsonObjectConst;
+struct JsonArrayConst;
+
+struct JsonVariantConst {
+    bool isNull() const { return true; }
+    template <typename T> T as() const { return T(); }
+    template <typename T> T operator|(T fallback) const { return fallback; }
+    const char* operator|(const char* fallback) const { return fallback; }
+    operator JsonObjectConst() const;
+    operator JsonArrayConst() const;
+};
+
+struct JsonObjectConst {
+    JsonVariantConst operator[](const char*) const { return JsonVariantConst(); }
+    bool containsKey(const char*) const { return false; }
+};
+
+struct JsonArrayConst {
+    bool isNull() const { return true; }
+    size_t size() const { return 0; }
+    JsonVariantConst operator[](size_t) const { return JsonVariantConst(); }
+};
+
+inline JsonVariantConst::operator JsonObjectConst() const { return JsonObjectConst(); }
+inline JsonVariantConst::operator JsonArrayConst() const { return JsonArrayConst(); }
+
+struct DynamicJsonDocument {
+    explicit DynamicJsonDocument(size_t) {}
+    JsonVariantConst operator[](const char*) const { return JsonVariantConst(); }
+};
+
+struct DeserializationError {
+    explicit operator bool() const { return true; }
+    const char* c_str() const { return "unsupported on host"; }
+};
+
+template <typename Source>
+DeserializationError deserializeJson(DynamicJsonDocument &, Source &) { return DeserializationError(); }
+
+#endif // HOST_ARDUINOJSON_H
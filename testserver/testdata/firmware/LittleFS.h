@@ -0,0 +1,20 @@
+// Host stand-in: AlertEngine::loadFromFile compiles against this but the
+// host checks never call it.
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <Arduino.h>
+
+struct File {
+    explicit operator bool() const { return false; }
+    void close() {}
+};
+
+struct HostFS {
+    bool exists(const char*) { return false; }
+    File open(const char*, const char*) { return File(); }
+};
+
+inline HostFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
@@ -0,0 +1,53 @@
+// Line-oriented driver for firmware_test.go. Each input line is a command,
+// each output line its result:
+//
+//   parse <json>
+//     parseMetricsJson on the rest of the line; prints "ok " and the
+//     snapshot re-encoded by writeMetricsJson, or "reject"
+//
+//   held <now_ms> <interval_ms> <latency>
+//     AlertEngine::sampleHeld with a healthy snapshot at that latency;
+//     prints "<1 if sampled, else 0> <active rule name, or ->"
+#include "AlertRules.h"
+#include "Config.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int main() {
+    AlertEngine alerts;
+    std::string line;
+
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+
+        if (command == "parse") {
+            std::string json = line.substr(line.find(' ') + 1);
+            MetricsData data = MetricsData();
+            char out[METRICS_JSON_SIZE];
+            if (parseMetricsJson(json.data(), json.size(), data) &&
+                writeMetricsJson(out, sizeof(out), data) > 0) {
+                std::cout << "ok " << out << '\n';
+            } else {
+                std::cout << "reject\n";
+            }
+        } else if (command == "held") {
+            unsigned long now, interval;
+            int latency;
+            in >> now >> interval >> latency;
+
+            MetricsData data = MetricsData();
+            data.status = 1;
+            data.latency = latency;
+            bool sampled = alerts.sampleHeld(data, -60, now, interval);
+            const AlertRule* rule = alerts.activeRule();
+            std::cout << (sampled ? 1 : 0) << ' ' << (rule != nullptr ? rule->name : "-") << '\n';
+        } else {
+            std::cout << "unknown command\n";
+        }
+    }
+    return 0;
+}